@@ -70,6 +70,7 @@ void HLMACAddressTable::initialize()
 {
     agingTime = par("agingTime");
     lastPurge = SIMTIME_ZERO;
+    agingTimer = new cMessage("agingTimer");
 
     HLMACTable& hlmacTable = *this->hlmacTable;    // magic to hide the '*' from the name of the watch below
     WATCH_MAP(hlmacTable);
@@ -83,9 +84,12 @@ void HLMACAddressTable::initialize()
  * that line will not be read in, hence must terminate file with unused line.
  */
 
-void HLMACAddressTable::handleMessage(cMessage *)
+void HLMACAddressTable::handleMessage(cMessage *msg)
 {
-    throw cRuntimeError("This module doesn't process messages");
+    if (msg == agingTimer)
+        removeAgedEntriesFromAllVlans();
+    else
+        throw cRuntimeError("This module doesn't process messages");
 }
 
 /*
@@ -105,6 +109,82 @@ HLMACAddressTable::HLMACTable *HLMACAddressTable::getTableForVid(unsigned int vi
     return nullptr;
 }
 
+/*
+ * getTrieForVid
+ * Returns the prefix trie of the MAC Address Table for a specified VLAN ID
+ */
+
+HLMACAddressTable::TrieNode *HLMACAddressTable::getTrieForVid(unsigned int vid, bool create)
+{
+    auto iter = vlanPrefixTrie.find(vid);
+    if (iter != vlanPrefixTrie.end())
+        return iter->second;
+    if (!create)
+        return nullptr;
+    TrieNode *root = new TrieNode();
+    vlanPrefixTrie[vid] = root;
+    return root;
+}
+
+unsigned int HLMACAddressTable::getTrieLength(const HLMACAddress& address)
+{
+    unsigned int length = address.getHLMACLength();
+    while ((length > 0) && (address.getIndexValue(length - 1) == 0))
+        length--;
+    return length;
+}
+
+HLMACAddressTable::TrieNode *HLMACAddressTable::findTrieNode(TrieNode *root, const HLMACAddress& address, unsigned int length)
+{
+    TrieNode *node = root;
+    for (unsigned int i = 0; (node != nullptr) && (i < length); i++) {
+        auto child = node->children.find(address.getIndexValue(i));
+        node = (child != node->children.end()) ? child->second : nullptr;
+    }
+    return node;
+}
+
+void HLMACAddressTable::insertEntry(HLMACTable::iterator iter)
+{
+    TrieNode *node = getTrieForVid(iter->second.vid, true);
+    unsigned int length = getTrieLength(iter->first);
+    node->numEntries++;
+    for (unsigned int i = 0; i < length; i++) {
+        unsigned int id = iter->first.getIndexValue(i);
+        TrieNode *& child = node->children[id];
+        if (child == nullptr)
+            child = new TrieNode(node, id);
+        node = child;
+        node->numEntries++;
+    }
+    node->hasEntry = true;
+    node->entry = iter;
+    node->agingPos = agingList.insert(agingList.end(), node);
+    if ((agingTimer != nullptr) && !agingTimer->isScheduled())
+        scheduleAgingTimer();
+}
+
+void HLMACAddressTable::eraseEntry(HLMACTable *table, HLMACTable::iterator iter)
+{
+    TrieNode *root = getTrieForVid(iter->second.vid);
+    TrieNode *node = findTrieNode(root, iter->first, getTrieLength(iter->first));
+    if ((node == nullptr) || (!node->hasEntry) || (node->entry != iter))
+        throw cRuntimeError("HLMACAddressTable::eraseEntry(): address %s is not in the prefix trie", iter->first.str().c_str());
+    agingList.erase(node->agingPos);
+    node->hasEntry = false;
+    // walk up to the root, deleting the nodes which have no entry below them any more
+    while (node != nullptr) {
+        TrieNode *parent = node->parent;
+        node->numEntries--;
+        if ((node->numEntries == 0) && (parent != nullptr)) {
+            parent->children.erase(node->id);
+            delete node;
+        }
+        node = parent;
+    }
+    table->erase(iter);
+}
+
 /*
  * For a known arriving port, V-TAG and destination MAC. It generates a vector with the ports where relay component
  * should deliver the message.
@@ -126,10 +206,9 @@ int HLMACAddressTable::getPortForAddress(HLMACAddress& address, unsigned int vid
         // not found
         return -1;
     }
-    if (iter->second.insertionTime + agingTime <= simTime()) {
-        // don't use (and throw out) aged entries
-        EV << "Ignoring and deleting aged entry: " << iter->first << " --> port" << iter->second.portno << "\n";
-        table->erase(iter);
+    if (isAged(iter->second)) {
+        // don't use aged entries, agingTimer throws them out
+        EV << "Ignoring aged entry: " << iter->first << " --> port" << iter->second.portno << "\n";
         return -1;
     }
     return iter->second.portno;
@@ -164,11 +243,9 @@ bool HLMACAddressTable::updateTableWithAddress(int portno, HLMACAddress& address
         iter = table->find(address);
 
     if (iter == table->end()) {
-        removeAgedEntriesIfNeeded();
-
         // Add entry to table
         EV << "Adding entry to Address Table: " << address << " --> port" << portno << "\n";
-        (*table)[address] = AddressEntry(vid, portno, simTime());
+        insertEntry(table->insert(std::make_pair(address, AddressEntry(vid, portno, simTime()))).first);
         return false;
     }
     else {
@@ -177,6 +254,9 @@ bool HLMACAddressTable::updateTableWithAddress(int portno, HLMACAddress& address
         AddressEntry& entry = iter->second;
         entry.insertionTime = simTime();
         entry.portno = portno;
+        // the refreshed entry is now the youngest one
+        TrieNode *node = findTrieNode(getTrieForVid(vid), iter->first, getTrieLength(iter->first));
+        agingList.splice(agingList.end(), agingList, node->agingPos);
     }
     return true;
 }
@@ -193,7 +273,7 @@ void HLMACAddressTable::flush(int portno)
         for (auto j = table->begin(); j != table->end(); ) {
             auto cur = j++;
             if (cur->second.portno == portno)
-                table->erase(cur);
+                eraseEntry(table, cur);
         }
     }
 }
@@ -229,33 +309,45 @@ void HLMACAddressTable::removeAgedEntriesFromVlan(unsigned int vid)
     HLMACTable *table = getTableForVid(vid);
     if (table == nullptr)
         return;
-    // TODO: this part could be factored out
-    for (auto iter = table->begin(); iter != table->end(); ) {
-        auto cur = iter++;    // iter will get invalidated after erase()
-        AddressEntry& entry = cur->second;
-        if (entry.insertionTime + agingTime <= simTime()) {
+    // aged entries are at the front of agingList
+    for (auto iter = agingList.begin(); (iter != agingList.end()) && isAged((*iter)->entry->second); ) {
+        auto cur = (*iter++)->entry;    // iter will get invalidated after erase()
+        if (cur->second.vid == vid) {
             EV << "Removing aged entry from Address Table: "
                << cur->first << " --> port" << cur->second.portno << "\n";
-            table->erase(cur);
+            eraseEntry(table, cur);
         }
     }
 }
 
 void HLMACAddressTable::removeAgedEntriesFromAllVlans()
 {
-    for (auto & elem : vlanHLMACTable) {
-        HLMACTable *table = elem.second;
-        // TODO: this part could be factored out
-        for (auto j = table->begin(); j != table->end(); ) {
-            auto cur = j++;    // iter will get invalidated after erase()
-            AddressEntry& entry = cur->second;
-            if (entry.insertionTime + agingTime <= simTime()) {
-                EV << "Removing aged entry from Address Table: "
-                   << cur->first << " --> port" << cur->second.portno << "\n";
-                table->erase(cur);
-            }
-        }
+    Enter_Method_Silent();
+    // aged entries are at the front of agingList
+    while (!agingList.empty() && isAged(agingList.front()->entry->second)) {
+        auto cur = agingList.front()->entry;
+        EV << "Removing aged entry from Address Table: "
+           << cur->first << " --> port" << cur->second.portno << "\n";
+        eraseEntry(getTableForVid(cur->second.vid), cur);
+    }
+    scheduleAgingTimer();
+}
+
+void HLMACAddressTable::scheduleAgingTimer()
+{
+    if (agingList.empty()) {
+        cancelEvent(agingTimer);
+        return;
     }
+    simtime_t expiryTime = agingList.front()->entry->second.insertionTime + agingTime;
+    if (expiryTime < simTime())
+        expiryTime = simTime();
+    if (agingTimer->isScheduled()) {
+        if (agingTimer->getArrivalTime() == expiryTime)
+            return;
+        cancelEvent(agingTimer);
+    }
+    scheduleAt(expiryTime, agingTimer);
 }
 
 void HLMACAddressTable::removeAgedEntriesIfNeeded()
@@ -270,27 +362,42 @@ void HLMACAddressTable::removeAgedEntriesIfNeeded()
 
 void HLMACAddressTable::clearTable()
 {
+    Enter_Method_Silent();
+
     for (auto & elem : vlanHLMACTable)
         delete elem.second;
+    for (auto & elem : vlanPrefixTrie)
+        delete elem.second;
 
     vlanHLMACTable.clear();
+    vlanPrefixTrie.clear();
+    agingList.clear();
+    if (agingTimer != nullptr)
+        cancelEvent(agingTimer);
     hlmacTable = nullptr;
 }
 
 HLMACAddressTable::~HLMACAddressTable()
 {
+    cancelAndDelete(agingTimer);
     for (auto & elem : vlanHLMACTable)
         delete elem.second;
+    for (auto & elem : vlanPrefixTrie)
+        delete elem.second;
 }
 
 void HLMACAddressTable::setAgingTime(simtime_t agingTime)
 {
+    Enter_Method_Silent();
     this->agingTime = agingTime;
+    scheduleAgingTimer();
 }
 
 void HLMACAddressTable::resetDefaultAging()
 {
+    Enter_Method_Silent();
     agingTime = par("agingTime");
+    scheduleAgingTimer();
 }
 
 bool HLMACAddressTable::isPortInTable(int portno, unsigned int vid)
@@ -313,26 +420,28 @@ bool HLMACAddressTable::isPortInTable(int portno, unsigned int vid)
 HLMACAddress HLMACAddressTable::getlongestMatchedPrefix(HLMACAddress address, unsigned int vid)
 {
     HLMACTable *table = getTableForVid(vid);
-        if (table == nullptr)
-            return HLMACAddress::UNSPECIFIED_ADDRESS;
-        address.removeLastId(); //an address is not prefix of itself
-
-        while(address != HLMACAddress::UNSPECIFIED_ADDRESS){
-            auto iter = table->find(address);
-            if (iter != table->end()) {
-                if (iter->second.insertionTime + agingTime <= simTime()) {
-                    // don't use (and throw out) aged entries
-                    EV << "Ignoring and deleting aged entry: " << iter->first << " --> port" << iter->second.portno << "\n";
-                    table->erase(iter);
-                }else
-                    return address;
-            }
-            address.removeLastId();
-        }//while
-
+    TrieNode *root = getTrieForVid(vid);
+    if ((table == nullptr) || (root == nullptr))
         return HLMACAddress::UNSPECIFIED_ADDRESS;
+    unsigned int maxLength = address.getHLMACHier(); //an address is not prefix of itself
+
+    // one walk down the trie, remembering the deepest entry which is not aged (agingTimer throws aged entries out)
+    unsigned int matchedLength = 0;
+    TrieNode *node = root;
+    for (unsigned int i = 0; i < maxLength; i++) {
+        auto child = node->children.find(address.getIndexValue(i));
+        if (child == node->children.end())
+            break;
+        node = child->second;
+        if (node->hasEntry && !isAged(node->entry->second))
+            matchedLength = i + 1;
+    }
 
-
+    if (matchedLength == 0)
+        return HLMACAddress::UNSPECIFIED_ADDRESS;
+    for (unsigned int i = matchedLength; i < address.getHLMACLength(); i++)
+        address.setIndexValue(i, 0);
+    return address;
 }
 
 bool HLMACAddressTable::isMyAddress(HLMACAddress address, unsigned int vid)
@@ -342,16 +451,8 @@ bool HLMACAddressTable::isMyAddress(HLMACAddress address, unsigned int vid)
             return false;
 
         auto iter = table->find(address);
-        if (iter != table->end()) {
-            if (iter->second.insertionTime + agingTime <= simTime()) {
-                // don't use (and throw out) aged entries
-                EV << "Ignoring and deleting aged entry: " << iter->first << " --> port" << iter->second.portno << "\n";
-                table->erase(iter);
-                return false;
-            }else
-                return true;
-        }
-        return false;
+        // don't use aged entries, agingTimer throws them out
+        return (iter != table->end()) && !isAged(iter->second);
 }
 
 HLMACAddress HLMACAddressTable::getSrcAddress(HLMACAddress address, MetricType metric, unsigned int vid)
@@ -364,11 +465,15 @@ HLMACAddress HLMACAddressTable::getSrcAddress(HLMACAddress address, MetricType m
 
     //if (address == HLMACAddress::BROADCAST_ADDRESS){
         if (metric == HopCount){
+            //the address nearest to a unicast destination, the shortest one for broadcast
+            if (address != HLMACAddress::BROADCAST_ADDRESS){
+                getMinHopCount(address, selected, vid);
+                return selected;
+            }
             for (auto iter = table->begin(); iter != table->end(); iter++){
-                if (iter->second.insertionTime + agingTime <= simTime()) {
-                    // don't use (and throw out) aged entries
-                    EV << "Ignoring and deleting aged entry: " << iter->first << " --> port" << iter->second.portno << "\n";
-                    table->erase(iter);
+                if (isAged(iter->second)) {
+                    // don't use aged entries, agingTimer throws them out
+                    EV << "Ignoring aged entry: " << iter->first << " --> port" << iter->second.portno << "\n";
                 }else
                     if (selected == HLMACAddress::UNSPECIFIED_ADDRESS)
                         selected = iter->first;
@@ -386,6 +491,32 @@ HLMACAddress HLMACAddressTable::getSrcAddress(HLMACAddress address, MetricType m
 //    }  //end broadcast
 }
 
+int HLMACAddressTable::getMinHopCount(const HLMACAddress& dstAddress, HLMACAddress& srcAddress, unsigned int vid)
+{
+    int minHopCount = -1;
+    srcAddress = HLMACAddress::UNSPECIFIED_ADDRESS;
+
+    HLMACTable *table = getTableForVid(vid);
+    if (table == nullptr)
+        return minHopCount;
+
+    HLMACAddress dst = dstAddress;
+    unsigned int dstLength = dst.getHLMACHier() + 1;
+    // one ordered pass, the length of the common ancestor is computed without building it
+    for (auto & elem : *table){
+        if (isAged(elem.second))
+            continue;  // don't use aged entries, agingTimer throws them out
+        HLMACAddress temp = elem.first;
+        int hopCount = (temp.getHLMACHier() + 1) + dstLength - 2 * temp.getLongestCommonPrefixLength(dst);
+        if ((minHopCount == -1) || (hopCount < minHopCount)){
+            minHopCount = hopCount;
+            srcAddress = elem.first;
+        }
+    }
+
+    return minHopCount;
+}
+
 HLMACAddress HLMACAddressTable::getNearestTo(const HLMACAddress& other, unsigned int vid)
 {
     HLMACAddress nearest = HLMACAddress::UNSPECIFIED_ADDRESS;
@@ -395,10 +526,9 @@ HLMACAddress HLMACAddressTable::getNearestTo(const HLMACAddress& other, unsigned
             return nearest;
 
         for (auto iter = table->begin(); iter != table->end(); iter++){
-            if (iter->second.insertionTime + agingTime <= simTime()) {
-                // don't use (and throw out) aged entries
-                EV << "Ignoring and deleting aged entry: " << iter->first << " --> port" << iter->second.portno << "\n";
-                table->erase(iter);
+            if (isAged(iter->second)) {
+                // don't use aged entries, agingTimer throws them out
+                EV << "Ignoring aged entry: " << iter->first << " --> port" << iter->second.portno << "\n";
             }else
                 if (nearest == HLMACAddress::UNSPECIFIED_ADDRESS)
                     nearest = iter->first;
@@ -431,10 +561,9 @@ HLMACAddress HLMACAddressTable::getShortestAddressForPrefix(HLMACAddress prefix,
             return shortestAddress;
 
         for (auto iter = table->begin(); iter != table->end(); iter++){
-            if (iter->second.insertionTime + agingTime <= simTime()) {
-                // don't use (and throw out) aged entries
-                EV << "Ignoring and deleting aged entry: " << iter->first << " --> port" << iter->second.portno << "\n";
-                table->erase(iter);
+            if (isAged(iter->second)) {
+                // don't use aged entries, agingTimer throws them out
+                EV << "Ignoring aged entry: " << iter->first << " --> port" << iter->second.portno << "\n";
             }else
                 if (shortestAddress == HLMACAddress::UNSPECIFIED_ADDRESS){
                     shortestAddress = iter->first;
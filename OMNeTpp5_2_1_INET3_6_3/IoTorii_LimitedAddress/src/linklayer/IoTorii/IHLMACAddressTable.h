@@ -119,6 +119,10 @@ class IHLMACAddressTable
 
     virtual HLMACAddress getSrcAddress(HLMACAddress address, MetricType metric, unsigned int vid = 0) = 0;
 
+    //Used for hopCount metric, the minimum hop count between dstAddress and the (not aged) addresses of the table, or -1 if
+    //there is none. srcAddress is set to the first address with that hop count, in table order
+    virtual int getMinHopCount(const HLMACAddress& dstAddress, HLMACAddress& srcAddress, unsigned int vid = 0) = 0;
+
     virtual HLMACAddress getNearestTo(const HLMACAddress& other, unsigned int vid = 0) = 0;
 
     virtual bool isNearest(const HLMACAddress& addr, const HLMACAddress& other, unsigned int vid = 0) = 0;
@@ -201,6 +201,15 @@ HLMACAddress HLMACAddress::getLongestCommonPrefix(const HLMACAddress& other)
     return commonPrexif;
 }
 
+unsigned int HLMACAddress::getLongestCommonPrefixLength(const HLMACAddress& other) const
+{
+    unsigned int prefixLength = 0;
+    for (unsigned int i = 0; (i < getHLMACLength()) && (getIndexValue(i) == other.getIndexValue(i)); i++)
+        if (getIndexValue(i) != 0)
+            prefixLength = i + 1;
+    return prefixLength;
+}
+
 bool HLMACAddress::isPrefixOf(HLMACAddress other)
 {
     if (other.address == 0 || address == 0)
@@ -175,6 +175,9 @@ public:
 
   HLMACAddress getLongestCommonPrefix(const HLMACAddress& other);
 
+  //Used for hopCount metric, getLongestCommonPrefix().getHLMACHier() + 1 (0 if there is no common prefix) without building the prefix
+  unsigned int getLongestCommonPrefixLength(const HLMACAddress& other) const;
+
   bool isPrefixOf(HLMACAddress other);
 
 };
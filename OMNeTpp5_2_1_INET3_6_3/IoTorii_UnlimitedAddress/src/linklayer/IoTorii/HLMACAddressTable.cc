@@ -334,6 +334,17 @@ HLMACAddress HLMACAddressTable::getlongestMatchedPrefix(HLMACAddress address, un
 
 
 }
+
+bool HLMACAddressTable::isMyAddress(HLMACAddress address, unsigned int vid)
+{
+    HLMACTable *table = getTableForVid(vid);
+        if (table == nullptr)
+            return false;
+
+        auto iter = table->find(address);
+        // don't use aged entries
+        return (iter != table->end()) && (iter->second.insertionTime + agingTime > simTime());
+}
 //EXTRA END
 
 } // namespace iotorii
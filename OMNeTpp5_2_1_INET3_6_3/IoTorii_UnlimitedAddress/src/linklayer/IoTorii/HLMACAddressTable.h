@@ -158,6 +158,8 @@ class HLMACAddressTable : public cSimpleModule, public IHLMACAddressTable
 
     //EXTRA BEGIN
     virtual HLMACAddress getlongestMatchedPrefix(HLMACAddress hlmac, unsigned int vid = 0) override;
+
+    virtual bool isMyAddress(HLMACAddress address, unsigned int vid = 0) override;
     //EXTRA END
 
 
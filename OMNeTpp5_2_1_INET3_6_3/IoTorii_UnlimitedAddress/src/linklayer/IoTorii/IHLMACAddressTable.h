@@ -115,6 +115,9 @@ class IHLMACAddressTable
 
     //EXTRA BEGIN
     virtual HLMACAddress getlongestMatchedPrefix(HLMACAddress hlmac, unsigned int vid = 0) = 0;
+
+    //true if address is in the table (not aged), the entries of this node have no port, so getPortForAddress() cannot tell
+    virtual bool isMyAddress(HLMACAddress address, unsigned int vid = 0) = 0;
     //EXTRA END
 
 };
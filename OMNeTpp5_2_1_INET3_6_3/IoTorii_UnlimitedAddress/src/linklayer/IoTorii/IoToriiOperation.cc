@@ -119,6 +119,13 @@ IoToriiOperation::IoToriiOperation() :
     numHLMACAssigned(0),
     numHLMACLoopable(0),
     numHLMACSent(0),
+    numHLMACRefreshed(0),
+    numTrickleSuppressed(0),
+    useTrickle(false),
+    trickleK(1),
+    trickleMaxIntervals(0),
+    trickleTransmitTimer(nullptr),
+    trickleIntervalTimer(nullptr),
     maxNeighbors(0),
     maxHLMACs(-1),
     hlmacTable(nullptr),
@@ -157,6 +164,18 @@ void IoToriiOperation::initialize(int stage)
 
         jitterPar = &par("jitter");
 
+        useTrickle = par("useTrickle");
+        if (useTrickle){
+            trickleImin = par("trickleImin");
+            int doublings = par("trickleImaxDoublings");
+            trickleK = par("trickleK");
+            trickleMaxIntervals = par("trickleMaxIntervals");
+            if ((trickleImin <= 0) || (doublings < 0) || (trickleK < 0) || (trickleMaxIntervals < 0))
+                throw cRuntimeError("trickleImin must be positive, trickleImaxDoublings, trickleK and trickleMaxIntervals must not be negative");
+            trickleImax = trickleImin * pow(2, doublings);
+            WATCH(trickleInterval);
+            WATCH(numTrickleSuppressed);
+        }
 
         //WATCH(jitterPar->doubleValue());
         WATCH(maxHLMACs);
@@ -178,6 +197,7 @@ void IoToriiOperation::initialize(int stage)
         WATCH(numHLMACAssigned);
         WATCH(numHLMACLoopable);
         WATCH(numHLMACSent);
+        WATCH(numHLMACRefreshed);
         WATCH(numDiscardedNoHLMAC);
 
         WATCH(numReceivedUpperPacket);
@@ -210,7 +230,14 @@ void IoToriiOperation::initialize(int stage)
         scheduleAt(helloStartTime, HelloTimer); //Next Hello broadcasting
 
         hlmacTable = check_and_cast<IHLMACAddressTable *>(getModuleByPath(par("hlmacTablePath")));
-        myMACAddress = check_and_cast<CSMAIoTorii *>(getParentModule()->getSubmodule("mac802154"))->getMACAddress();
+        CSMAIoTorii *mac = check_and_cast<CSMAIoTorii *>(getParentModule()->getSubmodule("mac802154"));
+        myMACAddress = mac->getMACAddress();
+        if (useTrickle){
+            if (!mac->par("overhearSetHLMAC").boolValue())
+                throw cRuntimeError("useTrickle needs overhearSetHLMAC = true in the MAC, Trickle counts the SetHLMAC frames of the neighbors");
+            trickleTransmitTimer = new cMessage("trickleTransmitTimer");
+            trickleIntervalTimer = new cMessage("trickleIntervalTimer");
+        }
         corePrefix = par("corePrefix");
         if (isCoreSwitch = par("isCoreSwitch"))
         {
@@ -265,7 +292,7 @@ void IoToriiOperation::sendAndScheduleHello()
     helloStartTime+= helloInterval;
     //scheduleAt(helloStartTime, HelloTimer); //Next Hello broadcasting
 
-    CSMAFrameIoTorii *macPkt = new CSMAFrameIoTorii("Hello!");
+    CSMAFrameIoTorii *macPkt = new CSMAFrameIoTorii("Hello!", IOTORII_HELLO);
     AddressStruct dst;
     dst.MAC = MACAddress::BROADCAST_ADDRESS;
     macPkt->setDestAddr(dst);
@@ -297,13 +324,16 @@ void IoToriiOperation::startCore(int core)
     eGA3Frame eGA3(type,coreAddress);
 
     //preparing CSMA frame
-    CSMAFrameIoTorii *SetHLMACFrame = new CSMAFrameIoTorii ("SetHLMAC");
+    CSMAFrameIoTorii *SetHLMACFrame = new CSMAFrameIoTorii ("SetHLMAC", IOTORII_SETHLMAC);
     AddressStruct src;
     src.eGA3 = eGA3;
     SetHLMACFrame->setSrcAddr(src);
     SetHLMACFrame->setBitLength(headerLength);  //size of IEEE802.15.4 frame format without PANIDs
     EV << "SetHLMAC frame " << SetHLMACFrame->getSrcAddr().eGA3 << " is disseminated to the neighbors." << endl;
-    sendToNeighbors(SetHLMACFrame);
+    if (useTrickle)
+        addTricklePrefix(SetHLMACFrame);
+    else
+        sendToNeighbors(SetHLMACFrame);
 
     EV << "<-IoToriiOperation::startCore()" << endl;
 }
@@ -346,6 +376,85 @@ void IoToriiOperation::sendToNeighbors(CSMAFrameIoTorii *frame)
     EV << "<-IoToriiOperation::sendToNeighbors()" << endl;
 }
 
+void IoToriiOperation::addTricklePrefix(CSMAFrameIoTorii *frame)
+{
+    HLMACAddress prefix = frame->getSrcAddr().eGA3.getHLMACAddress();
+    delete frame;
+    EV << "Prefix " << prefix << " is new, the Trickle interval is reset" << endl;
+    TricklePrefix tricklePrefix = {prefix, 0, 0, false};
+    tricklePrefixes.push_back(tricklePrefix);
+    resetTrickle();
+}
+
+void IoToriiOperation::startTrickleInterval()
+{
+    for (auto & tricklePrefix : tricklePrefixes)
+        tricklePrefix.counter = 0;
+    cancelEvent(trickleTransmitTimer);
+    cancelEvent(trickleIntervalTimer);
+    scheduleAt(simTime() + uniform(trickleInterval / 2, trickleInterval), trickleTransmitTimer);
+    scheduleAt(simTime() + trickleInterval, trickleIntervalTimer);
+    EV << "Trickle interval " << trickleInterval << " started, transmission at " << trickleTransmitTimer->getArrivalTime() << endl;
+}
+
+void IoToriiOperation::resetTrickle()
+{
+    //RFC 6206, 4.2 step 6: nothing to do if I is already Imin
+    if ((trickleInterval == trickleImin) && trickleIntervalTimer->isScheduled())
+        return;
+    trickleInterval = trickleImin;
+    startTrickleInterval();
+}
+
+void IoToriiOperation::handleTrickleTransmitTimer()
+{
+    for (auto it = tricklePrefixes.begin(); it != tricklePrefixes.end(); ){
+        if (!hlmacTable->isMyAddress(it->prefix)){
+            it = tricklePrefixes.erase(it);  //removed from the HLMAC table (aging, flush)
+            continue;
+        }
+        TricklePrefix& tricklePrefix = *it++;
+        if ((trickleMaxIntervals != 0) && (tricklePrefix.numIntervals >= trickleMaxIntervals))
+            continue;
+        tricklePrefix.numIntervals++;
+        if (tricklePrefix.isSent && (trickleK != 0) && (tricklePrefix.counter >= trickleK)){
+            numTrickleSuppressed++;
+            EV << "Prefix " << tricklePrefix.prefix << " is suppressed, " << tricklePrefix.counter << " consistent SetHLMAC frames were heard" << endl;
+            continue;
+        }
+        tricklePrefix.isSent = true;
+
+        //preparing CSMA frame, as startCore()
+        eGA3Frame eGA3(SetHLMAC, tricklePrefix.prefix);
+        CSMAFrameIoTorii *SetHLMACFrame = new CSMAFrameIoTorii ("SetHLMAC", IOTORII_SETHLMAC);
+        AddressStruct src;
+        src.eGA3 = eGA3;
+        SetHLMACFrame->setSrcAddr(src);
+        SetHLMACFrame->setBitLength(headerLength);
+        EV << "SetHLMAC frame " << SetHLMACFrame->getSrcAddr().eGA3 << " is re-advertised to the neighbors by Trickle." << endl;
+        sendToNeighbors(SetHLMACFrame);
+    }
+}
+
+bool IoToriiOperation::isTrickleDone()
+{
+    if (trickleMaxIntervals == 0)
+        return false;
+    for (auto & tricklePrefix : tricklePrefixes)
+        if (tricklePrefix.numIntervals < trickleMaxIntervals)
+            return false;
+    return true;
+}
+
+void IoToriiOperation::countConsistentPrefixes(HLMACAddress hlmac)
+{
+    hlmac.removeLastId();  //address of the sender
+    hlmac.removeLastId();  //prefix that was offered to the sender
+    for (auto & tricklePrefix : tricklePrefixes)
+        if (tricklePrefix.prefix == hlmac)
+            tricklePrefix.counter++;
+}
+
 void IoToriiOperation::receiveSetHLMACMessage(CSMAFrameIoTorii *frame)
 {
     EV << "->IoToriiOperation::receiveSetHLMACMessage()" << endl;
@@ -358,12 +467,22 @@ void IoToriiOperation::receiveSetHLMACMessage(CSMAFrameIoTorii *frame)
 
     HLMACAddress hlmac = frame->getSrcAddr().eGA3.getHLMACAddress();
 
-    if (!hasLoop(hlmac)){
+    if (hlmacTable->isMyAddress(hlmac)){
+        //hasLoop() does not see the address itself, so a known address would be saved and advertised again
+        hlmacTable->updateTableWithAddress(-1, hlmac);
+        numHLMACRefreshed++;
+        EV << "HLMAC address " << hlmac << " is already assigned to this node, its entry is refreshed." << endl;
+        delete frame;
+    }
+    else if (!hasLoop(hlmac)){
         bool isSaved = saveHLMAC(hlmac);
         if (isSaved){
             EV << "HLMAC address " << hlmac << " has assigned to this node." << endl;
             EV << "Frame " << frame->getName() << " (src address: " << frame->getSrcAddr().eGA3 << ", dst address" << frame->getDestAddr().MAC<< " ) is resent to neighbors by this node after updating dst mac address field." << endl;
-            sendToNeighbors(frame);
+            if (useTrickle)
+                addTricklePrefix(frame);
+            else
+                sendToNeighbors(frame);
         }
         else{
             EV << "Frame " << frame->getName() << " (received from src mac address: " << frame->getSrcAddr().eGA3 << ", dst address" << frame->getDestAddr().MAC << " ) frame is dropped! table is full!" << endl;
@@ -461,6 +580,19 @@ void IoToriiOperation::handleSelfMessage(cMessage *msg)
         startCore(corePrefix);
         return;
     }
+    else if (msg == trickleTransmitTimer) {
+        handleTrickleTransmitTimer();
+        return;
+    }
+    else if (msg == trickleIntervalTimer) {
+        if (isTrickleDone()){
+            EV << "Trickle stops, every address was considered in " << trickleMaxIntervals << " intervals" << endl;
+            return;  //restarted by a new address or neighbor
+        }
+        trickleInterval = std::min(2 * trickleInterval, trickleImax);
+        startTrickleInterval();
+        return;
+    }
     else
         EV << "CSMAIoTorii Error: unknown SelfMessage:" << msg << endl;
     EV << "<-IoToriiOperation::handleSelfMessage()" << endl;
@@ -481,8 +613,8 @@ void IoToriiOperation::handleLowerPacket(cPacket *msg)
 
     numReceivedLowerPacket++;
 
-    if ((strcmp(msg->getName(),"Hello!")==0))
-    {
+    switch (msg->getKind()) {
+    case IOTORII_HELLO: {
         CSMAFrameIoTorii *frame = check_and_cast<CSMAFrameIoTorii *>(msg);
         numHelloRcvd++;
         //to check duplicate hello
@@ -498,18 +630,37 @@ void IoToriiOperation::handleLowerPacket(cPacket *msg)
             (*numNeighborsTotal)++;
             if (numNeighbors <= maxNeighbors)
                 (*numAllowedNeighborsTotal)++;
-            return;
+            //Trickle: a new neighbor has not been offered the addresses of this node yet
+            if (useTrickle && !tricklePrefixes.empty()){
+                for (auto & tricklePrefix : tricklePrefixes){
+                    tricklePrefix.numIntervals = 0;
+                    tricklePrefix.isSent = false;
+                }
+                resetTrickle();
+            }
         }
-        else {
+        else
             EV << "Hello message is received from : " << frame->getSrcAddr().MAC << "is duplicate." <<endl;
-            return;
-        }
+        delete frame;
+        return;
     } // END Hello
-    else if ((strcmp(msg->getName(),"SetHLMAC")==0)) {
+    case IOTORII_SETHLMAC: {
         CSMAFrameIoTorii *frame = check_and_cast<CSMAFrameIoTorii *>(msg);
+        if (useTrickle)
+            countConsistentPrefixes(frame->getSrcAddr().eGA3.getHLMACAddress());
+        if (frame->getDestAddr().MAC != myMACAddress){
+            //overheard (overhearSetHLMAC in the MAC), only used for the Trickle consistency
+            delete frame;
+            return;
+        }
         receiveSetHLMACMessage(frame);
         return;
     } //END SetHLMAC
+    default:
+        EV << "Frame " << msg->getName() << " of unknown kind " << msg->getKind() << " is dropped." << endl;
+        delete msg;
+        break;
+    }
     EV << "<-IoToriiOperation::handleLowerPacket()" << endl;
 }
 
@@ -566,6 +717,12 @@ void IoToriiOperation::stop()
 
     hlmacTable->clearTable();
     neighborList.clear();
+    if (useTrickle){
+        cancelEvent(trickleTransmitTimer);
+        cancelEvent(trickleIntervalTimer);
+        trickleInterval = 0;
+        tricklePrefixes.clear();
+    }
     isOperational = false;
 
     EV << "<-IoToriiOperation::stop()" << endl;
@@ -628,6 +785,9 @@ void IoToriiOperation::finish()
     recordScalar("numHLMACAssigned", numHLMACAssigned);
     recordScalar("numHLMACLoopable", numHLMACLoopable);
     recordScalar("numHLMACSent", numHLMACSent);
+    recordScalar("numHLMACRefreshed", numHLMACRefreshed);
+    if (useTrickle)
+        recordScalar("numTrickleSuppressed", numTrickleSuppressed);
     recordScalar("numDiscardedNoHLMAC", numDiscardedNoHLMAC);
 
     recordScalar("Received Upper Packets", numReceivedUpperPacket);
@@ -723,6 +883,18 @@ void IoToriiOperation::finish()
         HelloTimer = nullptr;
     }
 
+    if (trickleTransmitTimer != nullptr){
+        cancelEvent(trickleTransmitTimer);
+        delete trickleTransmitTimer;
+        trickleTransmitTimer = nullptr;
+    }
+
+    if (trickleIntervalTimer != nullptr){
+        cancelEvent(trickleIntervalTimer);
+        delete trickleIntervalTimer;
+        trickleIntervalTimer = nullptr;
+    }
+
     EV << "<-IoToriiOperation::finish()" << endl;
 }
 
@@ -739,6 +911,18 @@ IoToriiOperation::~IoToriiOperation()
         delete HelloTimer;
         HelloTimer = nullptr;
     }
+
+    if (trickleTransmitTimer != nullptr){
+        cancelEvent(trickleTransmitTimer);
+        delete trickleTransmitTimer;
+        trickleTransmitTimer = nullptr;
+    }
+
+    if (trickleIntervalTimer != nullptr){
+        cancelEvent(trickleIntervalTimer);
+        delete trickleIntervalTimer;
+        trickleIntervalTimer = nullptr;
+    }
 }
 
 } // namespace iotorii
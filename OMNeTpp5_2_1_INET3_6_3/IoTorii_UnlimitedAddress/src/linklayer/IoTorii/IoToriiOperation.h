@@ -97,6 +97,24 @@ public:
 
     cMessage *startCoreEvent;
 
+    //Trickle parameters and state (RFC 6206)
+    bool useTrickle;
+    simtime_t trickleImin;
+    simtime_t trickleImax;
+    int trickleK;
+    int trickleMaxIntervals;  //a prefix is considered in at most trickleMaxIntervals intervals, 0: no bound
+    simtime_t trickleInterval;  //I, zero until the first address is accepted
+    struct TricklePrefix
+    {
+        HLMACAddress prefix;  //an address of this node
+        int counter;  //c, consistent SetHLMAC frames heard in the current interval
+        int numIntervals;  //intervals in which the prefix was sent or suppressed
+        bool isSent;  //a prefix is never suppressed before it is sent
+    };
+    std::vector<TricklePrefix> tricklePrefixes;
+    cMessage *trickleTransmitTimer;  //t
+    cMessage *trickleIntervalTimer;  //end of the interval
+
     // Parameters for statistics collection
 
     long hlmacLenIsLow;
@@ -109,6 +127,8 @@ public:
     long numHLMACAssigned;
     long numHLMACLoopable;  //or num discarded HLMAC
     long numHLMACSent;
+    long numHLMACRefreshed;  //received addresses that were already in the HLMAC table (e.g. re-advertised by Trickle)
+    long numTrickleSuppressed;  //Trickle transmissions suppressed by consistent SetHLMAC frames
     long numDiscardedNoHLMAC; //if node has not HLMAC address, by dropping each packet, this variable is incremented.
 
     long numReceivedLowerPacket;
@@ -168,6 +188,24 @@ public:
     //Sends unicast SetHLMAC message to each neighbor, src is advertised HLMAC address to each node, dst is MAC address of each neighbor
     virtual void sendToNeighbors(CSMAFrameIoTorii *frame);
 
+    //Trickle: saves the prefix of frame as an address of this node to be advertised by the Trickle timer, and deletes frame
+    virtual void addTricklePrefix(CSMAFrameIoTorii *frame);
+
+    //Trickle: starts a new interval of length trickleInterval
+    virtual void startTrickleInterval();
+
+    //Trickle: an inconsistency (a new address or neighbor of this node) resets the interval to trickleImin
+    virtual void resetTrickle();
+
+    //Trickle: sends the addresses of this node that are not suppressed (sent before and trickleK consistent frames heard in the interval)
+    virtual void handleTrickleTransmitTimer();
+
+    //Trickle: true if every address of this node has been considered in trickleMaxIntervals intervals, the timer stops
+    virtual bool isTrickleDone();
+
+    //Trickle: hlmac, offered by a neighbor to its own neighbor, extends an address of this node by two IDs, so that neighbor has got the offer of that address
+    virtual void countConsistentPrefixes(HLMACAddress hlmac);
+
     //functionality of each node when it receives a SetHLMAC message
     virtual void receiveSetHLMACMessage(CSMAFrameIoTorii *SetHLMAC);
 
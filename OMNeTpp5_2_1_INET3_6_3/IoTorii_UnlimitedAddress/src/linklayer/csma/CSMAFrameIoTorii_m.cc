@@ -178,6 +178,13 @@ inline std::ostream& operator<<(std::ostream& out, const std::vector<T,A>& vec)
     return out;
 }
 
+EXECUTE_ON_STARTUP(
+    omnetpp::cEnum *e = omnetpp::cEnum::find("iotorii::IoToriiFrameKind");
+    if (!e) omnetpp::enums.getInstance()->add(e = new omnetpp::cEnum("iotorii::IoToriiFrameKind"));
+    e->insert(IOTORII_HELLO, "IOTORII_HELLO");
+    e->insert(IOTORII_SETHLMAC, "IOTORII_SETHLMAC");
+)
+
 Register_Class(CSMAFrameIoTorii)
 
 CSMAFrameIoTorii::CSMAFrameIoTorii(const char *name, short kind) : ::omnetpp::cPacket(name,kind)
@@ -32,7 +32,26 @@
 namespace iotorii {
 
 /**
- * Class generated from <tt>src/linklayer/csma/CSMAFrameIoTorii.msg:24</tt> by nedtool.
+ * Enum generated from <tt>src/linklayer/csma/CSMAFrameIoTorii.msg:27</tt> by nedtool.
+ * <pre>
+ * //
+ * // Kinds (cMessage::getKind()) of the IoTorii frames, the layers dispatch on them
+ * // instead of comparing the frame names.
+ * //
+ * enum IoToriiFrameKind
+ * {
+ *     IOTORII_HELLO = 1;
+ *     IOTORII_SETHLMAC = 2;
+ * }
+ * </pre>
+ */
+enum IoToriiFrameKind {
+    IOTORII_HELLO = 1,
+    IOTORII_SETHLMAC = 2
+};
+
+/**
+ * Class generated from <tt>src/linklayer/csma/CSMAFrameIoTorii.msg:33</tt> by nedtool.
  * <pre>
  * packet CSMAFrameIoTorii
  * {
@@ -66,6 +66,7 @@ void CSMAIoTorii::initialize(int stage)
     MACProtocolBase::initialize(stage);
     if (stage == INITSTAGE_LOCAL) {
         useMACAcks = par("useMACAcks").boolValue();
+        overhearSetHLMAC = par("overhearSetHLMAC").boolValue();  //EXTRA
         queueLength = par("queueLength");
         sifs = par("sifs");
         transmissionAttemptInterruptedByRx = false;
@@ -262,7 +263,7 @@ InterfaceEntry *CSMAIoTorii::createInterfaceEntry()
 void CSMAIoTorii::handleUpperPacket(cPacket *msg)
 {
     CSMAFrameIoTorii *macPkt = check_and_cast<CSMAFrameIoTorii *>(msg);
-    if (strcmp(macPkt->getName(), "Hello!") == 0){
+    if (macPkt->getKind() == IOTORII_HELLO){
         AddressStruct src;
         src.MAC = address;
         macPkt->setSrcAddr(src);
@@ -975,7 +976,8 @@ void CSMAIoTorii::handleLowerPacket(cPacket *msg)
     EV << "Received frame name= " << macPkt->getName()
               << ", myState=" << macState << endl;
 
-    if (strcmp(macPkt->getName(), "SetHLMAC") == 0){
+    switch (macPkt->getKind()) {
+    case IOTORII_SETHLMAC:
             if (macPkt->getDestAddr().MAC == address) {
                 if (!useMACAcks) {
                     EV_DETAIL << "Received a SetHLMAC packet addressed from MAC adress " << macPkt->getDestAddr().MAC <<" to me." << endl;
@@ -985,13 +987,23 @@ void CSMAIoTorii::handleLowerPacket(cPacket *msg)
                     throw cRuntimeError("CSMAIoTorii::handleLowerPacket(): useMACAcks is unsupported operation.");
                 }
             }
-    }
-    else if (strcmp(macPkt->getName(), "Hello!") == 0){
+            else if (overhearSetHLMAC) {
+                EV_DETAIL << "Overheard a SetHLMAC packet addressed to MAC address " << macPkt->getDestAddr().MAC << ", it is sent up without ack." << endl;
+                executeMac(EV_BROADCAST_RECEIVED, macPkt);
+            }
+            else
+                delete msg;
+            break;
+    case IOTORII_HELLO:
         if (macPkt->getDestAddr().MAC.isBroadcast())
             executeMac(EV_BROADCAST_RECEIVED, macPkt);
-    }
-    else
+        else
+            delete msg;
+        break;
+    default:
         delete msg;
+        break;
+    }
     /*
     else if (strcmp(macPkt->getName(), "SetHLMAC") != 0){
         EV << "packet not for me, I send up it to IoTorii sublayer to investigate it.\n";
@@ -97,6 +97,7 @@ public:
         , macMaxFrameRetries(0)
         , aUnitBackoffPeriod()
         , useMACAcks(false)
+        , overhearSetHLMAC(false)
         , backoffMethod(CONSTANT)
         , macMinBE(0)
         , macMaxBE(0)
@@ -277,6 +278,8 @@ public:
     simtime_t aUnitBackoffPeriod;
     /** @brief Stores if the MAC expects Acks for Unicast packets.*/
     bool useMACAcks;
+    /** @brief Stores if SetHLMAC frames addressed to other nodes are passed up.*/
+    bool overhearSetHLMAC;  //EXTRA
 
     /** @brief Defines the backoff method to be used.*/
     backoff_methods backoffMethod;
@@ -27,8 +27,8 @@
 #define IOTORII_SRC_LINKLAYER_COMMON_HLMACADDRESS_H_
 
 #define HLMAC_WIDTH 8
+#define HLMAC_INLINE_LENGTH 16  //number of IDs stored inside the object, deeper addresses spill to the heap
 
-#include <vector>
 //#include <iterator>
 #include "inet/common/INETDefs.h"
 
@@ -38,7 +38,16 @@ using namespace inet;
 class HLMACAddress {
 
 private:
-    std::vector<unsigned int> address;
+    unsigned int length;      // number of IDs in the address
+    unsigned int capacity;    // HLMAC_INLINE_LENGTH while the IDs are stored in inlineIds
+    unsigned int *ids;        // points to inlineIds, or to a heap block for very deep addresses
+    unsigned int inlineIds[HLMAC_INLINE_LENGTH];
+
+    void copyFrom(const HLMACAddress& other);
+
+    void reserve(unsigned int newCapacity);
+
+    void releaseStorage() { if (ids != inlineIds) delete[] ids; ids = inlineIds; capacity = HLMAC_INLINE_LENGTH; }
 
 public:
 
@@ -51,14 +60,16 @@ public:
   /**
    * Default constructor initializes address bytes to zero.
    */
-  HLMACAddress() { address = {0}; }  //{ address = {0,0,0,0,0,0,0,0}; }
+  HLMACAddress() : length(1), capacity(HLMAC_INLINE_LENGTH), ids(inlineIds) { inlineIds[0] = 0; }  //{ address = {0,0,0,0,0,0,0,0}; }
 
   /**
     * copy constructor
     */
-  HLMACAddress(const HLMACAddress& other) { address = other.address; }
+  HLMACAddress(const HLMACAddress& other) : length(0), capacity(HLMAC_INLINE_LENGTH), ids(inlineIds) { copyFrom(other); }
+
+  explicit HLMACAddress(const unsigned int array[], unsigned int arrayLength);  //e.g. HLMACAddress::BROADCAST_ADDRESS({255.255.255.255.255.255.255.255}, 8)
 
-  explicit HLMACAddress(unsigned int array[])  {  address.insert( address.begin(), array, array + sizeof array);}  //{  address.insert( address.begin(), array, array + sizeof array / sizeof array[0]);} //e.g. HLMACAddress::BROADCAST_ADDRESS({255.255.255.255.255.255.255.255})
+  ~HLMACAddress() { releaseStorage(); }
 
   /**
    * Returns the address width.
@@ -68,12 +79,12 @@ public:
   /**
    * Returns the address width.
    */
-  unsigned int getHLMACLength() const { return address.size(); }
+  unsigned int getHLMACLength() const { return length; }
 
     /**
    * Returns the value of index.
    */
-  unsigned int getIndexValue(unsigned int k) const {return address.at(k);}
+  unsigned int getIndexValue(unsigned int k) const { if (k >= length) throw cRuntimeError("HLMACAddress::getIndexValue(): index %u is not in range", k); return ids[k]; }
 
   /**
    * Converts address to a string.
@@ -83,22 +94,22 @@ public:
   /**
    * Sets the kth index of the address.
    */
-  void setIndexValue(unsigned int k, unsigned int addrbyte){address.at(k) = addrbyte;}
+  void setIndexValue(unsigned int k, unsigned int addrbyte){ if (k >= length) throw cRuntimeError("HLMACAddress::setIndexValue(): index %u is not in range", k); ids[k] = addrbyte; }
 
   /* add new suffix to frame. note that this method cannot insert new core.
    * for insertion new core, we can directly use setIndexValue(0, core) or setCore()
    */
-  void addNewId(unsigned int newPortId) {address.push_back(newPortId);}
+  void addNewId(unsigned int newPortId) { if (length == capacity) reserve(2 * capacity); ids[length++] = newPortId; }
 
-  void removeLastId() {address.pop_back(); }
+  void removeLastId() { if (length > 0) length--; }
 
-  void setCore(unsigned int newCoreId) {address.at(0) = newCoreId;}
+  void setCore(unsigned int newCoreId) { setIndexValue(0, newCoreId); }
 
   //unsigned short int getHLMACHier();
   /**
    * Assignment.
    */
-  HLMACAddress& operator=(const HLMACAddress& other) { address = other.address; return *this; }
+  HLMACAddress& operator=(const HLMACAddress& other) { if (this != &other) copyFrom(other); return *this; }
 
   /**
    * Returns -1, 0 or 1 as result of comparison of 2 addresses.
@@ -0,0 +1,49 @@
+#!/bin/bash
+# Runs the Scalability config of IoTorii_Benchmark.ini one run at a time (so the wall-clock time and the
+# memory of a run are not affected by the others) and writes one CSV line per run, e.g. to compare versions.
+#
+# Usage: runscalability.sh [-c "CONFIG..."] [CSVFILE]
+#   -c CONFIGS  configs to run (default: Scalability)
+#   CSVFILE     output (default: scalability-<git describe>.csv in this folder)
+#
+# The runs are done by ../../../runsweep.sh in sweep-scalability-<version>, so an interrupted suite is resumed
+# by the same command. IOTORII_BIN and IOTORII_NEDPATH are passed to it.
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+CONFIGS=Scalability
+
+while getopts "c:" OPTION; do
+	case $OPTION in
+	c) CONFIGS=$OPTARG ;;
+	*) sed -n '2,8p' "$0"; exit 1 ;;
+	esac
+done
+shift $((OPTIND - 1))
+
+VERSION=$(git -C "$HERE" describe --always --dirty 2> /dev/null || echo unknown)
+CSV=${1:-$HERE/scalability-$VERSION.csv}
+OUTDIR=$HERE/sweep-scalability-$VERSION
+
+"$HERE/../../../runsweep.sh" -j 1 -o "$OUTDIR" -c "$CONFIGS" "$HERE/IoTorii_Benchmark.ini"
+RV=$?
+
+# one line per run from the scalars of StatisticCollector, the missing ones (e.g. a run that did not converge) are empty
+COLUMNS="numNodes numJoinedNodes wallClockTime numEvents eventsPerSecond peakRSS peakRSSBeforeSetup peakRSSPerNode convergenceTime averageNumberOfMessages averageNumberOfEntries averageHopCount bootstrapTime"
+echo "version,config,run,iterationvars,${COLUMNS// /,}" > "$CSV"
+for SCA in "$OUTDIR"/merged/*.sca; do
+	[ -f "$SCA" ] || continue
+	awk -v version="$VERSION" -v columns="$COLUMNS" '
+		$1 == "attr" && $2 == "configname" { config = $3 }
+		$1 == "attr" && $2 == "runnumber" { run = $3 }
+		$1 == "attr" && $2 == "iterationvars" { $1 = ""; $2 = ""; sub(/^ +/, ""); gsub(/"/, ""); vars = $0 }
+		$1 == "scalar" && $2 ~ /\.statisticCollector$/ { value[$3] = $4 }
+		END {
+			n = split(columns, names, " ")
+			line = version "," config "," run ",\"" vars "\""
+			for (i = 1; i <= n; i++)
+				line = line "," value[names[i]]
+			print line
+		}' "$SCA" >> "$CSV"
+done
+echo "Results: $CSV"
+exit $RV
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2018 Elisa Rojas(1), Hedayat Hosseini(2);
+ *                    (1) GIST, University of Alcala, Spain.
+ *                    (2) CEIT, Amirkabir University of Technology (Tehran Polytechnic), Iran.
+ *                    OMNeT++ 5.2.1 & INET 3.6.3
+*/
+
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include "../IoTorii/HLMACAddressHashTable.h"
+
+namespace iotorii {
+using namespace inet;
+
+Define_Module(HLMACAddressHashTable);
+
+size_t HLMACAddressHashTable::hashAddress(const HLMACAddress& address, unsigned int vid)
+{
+    // multiplicative hashing of each ID (Fibonacci constant), the final shift mixes the high bits into the slot index
+    uint64 hash = vid;
+    unsigned int length = getTrieLength(address);
+    for (unsigned int i = 0; i < length; i++)
+        hash = (hash ^ address.getIndexValue(i)) * 0x9E3779B97F4A7C15ULL;
+    return (size_t)(hash ^ (hash >> 29));
+}
+
+size_t HLMACAddressHashTable::findSlot(HLMACTable::iterator iter)
+{
+    size_t mask = slots.size() - 1;
+    for (size_t i = hashAddress(iter->first, iter->second.vid) & mask; slots[i].used; i = (i + 1) & mask)
+        if (slots[i].entry == iter)
+            return i;
+    return slots.size();
+}
+
+void HLMACAddressHashTable::addSlot(size_t hash, unsigned int vid, HLMACTable::iterator entry)
+{
+    if (2 * (numUsedSlots + 1) > slots.size()) {
+        // rehash into twice as many slots
+        std::vector<Slot> oldSlots(2 * slots.size());
+        oldSlots.swap(slots);
+        numUsedSlots = 0;
+        for (auto & slot : oldSlots)
+            if (slot.used)
+                addSlot(slot.hash, slot.vid, slot.entry);
+    }
+    size_t mask = slots.size() - 1;
+    size_t i = hash & mask;
+    while (slots[i].used)
+        i = (i + 1) & mask;
+    slots[i].used = true;
+    slots[i].hash = hash;
+    slots[i].vid = vid;
+    slots[i].entry = entry;
+    numUsedSlots++;
+}
+
+void HLMACAddressHashTable::removeSlot(size_t index)
+{
+    size_t mask = slots.size() - 1;
+    slots[index].used = false;
+    numUsedSlots--;
+    for (size_t j = (index + 1) & mask; slots[j].used; j = (j + 1) & mask) {
+        size_t home = slots[j].hash & mask;
+        // slot j stays if its home is cyclically in (index, j]
+        bool stays = (index <= j) ? ((index < home) && (home <= j)) : ((index < home) || (home <= j));
+        if (!stays) {
+            slots[index] = slots[j];
+            slots[j].used = false;
+            index = j;
+        }
+    }
+}
+
+HLMACAddressTable::HLMACTable::iterator HLMACAddressHashTable::findEntry(HLMACTable *table, const HLMACAddress& address, unsigned int vid)
+{
+    size_t hash = hashAddress(address, vid);
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash & mask; slots[i].used; i = (i + 1) & mask)
+        if ((slots[i].hash == hash) && (slots[i].vid == vid) && (slots[i].entry->first.compareTo(address) == 0))
+            return slots[i].entry;
+    return table->end();
+}
+
+void HLMACAddressHashTable::insertEntry(HLMACTable::iterator iter)
+{
+    HLMACAddressTable::insertEntry(iter);
+    addSlot(hashAddress(iter->first, iter->second.vid), iter->second.vid, iter);
+}
+
+void HLMACAddressHashTable::eraseEntry(HLMACTable *table, HLMACTable::iterator iter)
+{
+    size_t index = findSlot(iter);
+    if (index == slots.size())
+        throw cRuntimeError("HLMACAddressHashTable::eraseEntry(): address %s is not in the hash index", iter->first.str().c_str());
+    removeSlot(index);
+    HLMACAddressTable::eraseEntry(table, iter);
+}
+
+void HLMACAddressHashTable::clearTable()
+{
+    HLMACAddressTable::clearTable();
+    slots.assign(16, Slot());
+    numUsedSlots = 0;
+}
+
+} // namespace iotorii
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2018 Elisa Rojas(1), Hedayat Hosseini(2);
+ *                    (1) GIST, University of Alcala, Spain.
+ *                    (2) CEIT, Amirkabir University of Technology (Tehran Polytechnic), Iran.
+ *                    OMNeT++ 5.2.1 & INET 3.6.3
+*/
+
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef IOTORII_SRC_LINKLAYER_GA3SWITCH_HLMACADDRESSHASHTABLE_H_
+#define IOTORII_SRC_LINKLAYER_GA3SWITCH_HLMACADDRESSHASHTABLE_H_
+
+#include "../IoTorii/HLMACAddressTable.h"
+
+#include <vector>
+
+namespace iotorii {
+using namespace inet;
+
+/**
+ * HLMACAddressTable with a flat open addressing (linear probing) hash index for the exact lookups
+ * of getPortForAddress() and updateTableWithAddress(). The ordered HLMACTable and the prefix trie
+ * are kept as secondary indexes, so getAddress(index), printState() and the prefix queries are unchanged.
+ * See the NED definition for details.
+ */
+class HLMACAddressHashTable : public HLMACAddressTable
+{
+  protected:
+    struct Slot
+    {
+        bool used = false;
+        size_t hash = 0;
+        unsigned int vid = 0;
+        HLMACTable::iterator entry;
+    };
+
+    std::vector<Slot> slots;    // size is a power of 2, at most half of the slots are used
+    unsigned int numUsedSlots = 0;
+
+  protected:
+    /**
+     * @brief Hash of vid and the IDs of address without its trailing zeros (compareTo() ignores them)
+     */
+    static size_t hashAddress(const HLMACAddress& address, unsigned int vid);
+
+    /**
+     * @brief Returns the slot of iter, or slots.size() if it is not indexed
+     */
+    size_t findSlot(HLMACTable::iterator iter);
+
+    void addSlot(size_t hash, unsigned int vid, HLMACTable::iterator entry);
+
+    /**
+     * @brief Frees a slot by shifting back the following slots of its probe sequence (no tombstones)
+     */
+    void removeSlot(size_t index);
+
+    virtual HLMACTable::iterator findEntry(HLMACTable *table, const HLMACAddress& address, unsigned int vid) override;
+
+    virtual void insertEntry(HLMACTable::iterator iter) override;
+
+    virtual void eraseEntry(HLMACTable *table, HLMACTable::iterator iter) override;
+
+  public:
+    HLMACAddressHashTable() : slots(16) {}
+
+    virtual void clearTable() override;
+};
+
+} // namespace iotorii
+
+#endif // ifndef IOTORII_SRC_LINKLAYER_GA3SWITCH_HLMACADDRESSHASHTABLE_H_
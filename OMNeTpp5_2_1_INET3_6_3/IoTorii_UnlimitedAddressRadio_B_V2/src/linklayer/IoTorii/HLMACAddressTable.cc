@@ -40,6 +40,8 @@
 //
 
 #include "../IoTorii/HLMACAddressTable.h"
+#include "src/linklayer/common/IoToriiLog.h"
+#include "src/linklayer/IoTorii/IoToriiSignals.h"
 
 #include <map>
 #include <vector>
@@ -53,6 +55,8 @@ using namespace inet;
 
 Define_Module(HLMACAddressTable);
 
+simsignal_t HLMACAddressTable::hlmacRemovedSignal = registerSignal("hlmacRemoved");
+
 std::ostream& operator<<(std::ostream& os, const HLMACAddressTable::AddressEntry& entry)
 {
     os << "{VID=" << entry.vid << ", port=" << entry.portno << ", insertionTime=" << entry.insertionTime << "}";
@@ -70,6 +74,7 @@ void HLMACAddressTable::initialize()
 {
     agingTime = par("agingTime");
     lastPurge = SIMTIME_ZERO;
+    agingTimer = new cMessage("agingTimer");
 
     HLMACTable& hlmacTable = *this->hlmacTable;    // magic to hide the '*' from the name of the watch below
     WATCH_MAP(hlmacTable);
@@ -83,9 +88,12 @@ void HLMACAddressTable::initialize()
  * that line will not be read in, hence must terminate file with unused line.
  */
 
-void HLMACAddressTable::handleMessage(cMessage *)
+void HLMACAddressTable::handleMessage(cMessage *msg)
 {
-    throw cRuntimeError("This module doesn't process messages");
+    if (msg == agingTimer)
+        removeAgedEntriesFromAllVlans();
+    else
+        throw cRuntimeError("This module doesn't process messages");
 }
 
 /*
@@ -105,6 +113,91 @@ HLMACAddressTable::HLMACTable *HLMACAddressTable::getTableForVid(unsigned int vi
     return nullptr;
 }
 
+/*
+ * getTrieForVid
+ * Returns the prefix trie of the MAC Address Table for a specified VLAN ID
+ */
+
+HLMACAddressTable::TrieNode *HLMACAddressTable::getTrieForVid(unsigned int vid, bool create)
+{
+    auto iter = vlanPrefixTrie.find(vid);
+    if (iter != vlanPrefixTrie.end())
+        return iter->second;
+    if (!create)
+        return nullptr;
+    TrieNode *root = new TrieNode();
+    vlanPrefixTrie[vid] = root;
+    return root;
+}
+
+unsigned int HLMACAddressTable::getTrieLength(const HLMACAddress& address)
+{
+    unsigned int length = address.getHLMACLength();
+    while ((length > 0) && (address.getIndexValue(length - 1) == 0))
+        length--;
+    return length;
+}
+
+HLMACAddressTable::TrieNode *HLMACAddressTable::findTrieNode(TrieNode *root, const HLMACAddress& address, unsigned int length)
+{
+    TrieNode *node = root;
+    for (unsigned int i = 0; (node != nullptr) && (i < length); i++) {
+        auto child = node->children.find(address.getIndexValue(i));
+        node = (child != node->children.end()) ? child->second : nullptr;
+    }
+    return node;
+}
+
+HLMACAddressTable::HLMACTable::iterator HLMACAddressTable::findEntry(HLMACTable *table, const HLMACAddress& address, unsigned int vid)
+{
+    return table->find(address);
+}
+
+void HLMACAddressTable::insertEntry(HLMACTable::iterator iter)
+{
+    TrieNode *node = getTrieForVid(iter->second.vid, true);
+    unsigned int length = getTrieLength(iter->first);
+    node->numEntries++;
+    for (unsigned int i = 0; i < length; i++) {
+        unsigned int id = iter->first.getIndexValue(i);
+        TrieNode *& child = node->children[id];
+        if (child == nullptr)
+            child = new TrieNode(node, id);
+        node = child;
+        node->numEntries++;
+    }
+    node->hasEntry = true;
+    node->entry = iter;
+    node->agingPos = agingList.insert(agingList.end(), node);
+    if ((agingTimer != nullptr) && !agingTimer->isScheduled())
+        scheduleAgingTimer();
+}
+
+void HLMACAddressTable::eraseEntry(HLMACTable *table, HLMACTable::iterator iter)
+{
+    TrieNode *root = getTrieForVid(iter->second.vid);
+    TrieNode *node = findTrieNode(root, iter->first, getTrieLength(iter->first));
+    if ((node == nullptr) || (!node->hasEntry) || (node->entry != iter))
+        throw cRuntimeError("HLMACAddressTable::eraseEntry(): address %s is not in the prefix trie", iter->first.str().c_str());
+    if (mayHaveListeners(hlmacRemovedSignal)) {
+        HLMACAddressDetails details(iter->first);
+        emit(hlmacRemovedSignal, simTime(), &details);
+    }
+    agingList.erase(node->agingPos);
+    node->hasEntry = false;
+    // walk up to the root, deleting the nodes which have no entry below them any more
+    while (node != nullptr) {
+        TrieNode *parent = node->parent;
+        node->numEntries--;
+        if ((node->numEntries == 0) && (parent != nullptr)) {
+            parent->children.erase(node->id);
+            delete node;
+        }
+        node = parent;
+    }
+    table->erase(iter);
+}
+
 /*
  * For a known arriving port, V-TAG and destination MAC. It generates a vector with the ports where relay component
  * should deliver the message.
@@ -120,16 +213,15 @@ int HLMACAddressTable::getPortForAddress(HLMACAddress& address, unsigned int vid
     if (table == nullptr)
         return -1;
 
-    auto iter = table->find(address);
+    auto iter = findEntry(table, address, vid);
 
     if (iter == table->end()) {
         // not found
         return -1;
     }
-    if (iter->second.insertionTime + agingTime <= simTime()) {
-        // don't use (and throw out) aged entries
-        EV << "Ignoring and deleting aged entry: " << iter->first << " --> port" << iter->second.portno << "\n";
-        table->erase(iter);
+    if (isAged(iter->second)) {
+        // don't use aged entries, agingTimer throws them out
+        IOTORII_EV(TABLE) << "Ignoring aged entry: " << iter->first << " --> port" << iter->second.portno << "\n";
         return -1;
     }
     return iter->second.portno;
@@ -161,22 +253,23 @@ bool HLMACAddressTable::updateTableWithAddress(int portno, HLMACAddress& address
         iter = table->end();
     }
     else
-        iter = table->find(address);
+        iter = findEntry(table, address, vid);
 
     if (iter == table->end()) {
-        removeAgedEntriesIfNeeded();
-
         // Add entry to table
-        EV << "Adding entry to Address Table: " << address << " --> port" << portno << "\n";
-        (*table)[address] = AddressEntry(vid, portno, simTime());
+        IOTORII_EV(TABLE) << "Adding entry to Address Table: " << address << " --> port" << portno << "\n";
+        insertEntry(table->insert(std::make_pair(address, AddressEntry(vid, portno, simTime()))).first);
         return false;
     }
     else {
         // Update existing entry
-        EV << "Updating entry in Address Table: " << address << " --> port" << portno << "\n";
+        IOTORII_EV(TABLE) << "Updating entry in Address Table: " << address << " --> port" << portno << "\n";
         AddressEntry& entry = iter->second;
         entry.insertionTime = simTime();
         entry.portno = portno;
+        // the refreshed entry is now the youngest one
+        TrieNode *node = findTrieNode(getTrieForVid(vid), iter->first, getTrieLength(iter->first));
+        agingList.splice(agingList.end(), agingList, node->agingPos);
     }
     return true;
 }
@@ -193,7 +286,7 @@ void HLMACAddressTable::flush(int portno)
         for (auto j = table->begin(); j != table->end(); ) {
             auto cur = j++;
             if (cur->second.portno == portno)
-                table->erase(cur);
+                eraseEntry(table, cur);
         }
     }
 }
@@ -204,12 +297,12 @@ void HLMACAddressTable::flush(int portno)
 
 void HLMACAddressTable::printState()
 {
-    EV << endl << "MAC Address Table" << endl;
-    EV << "VLAN ID    MAC    Port    Inserted" << endl;
+    IOTORII_EV(TABLE) << endl << "MAC Address Table" << endl;
+    IOTORII_EV(TABLE) << "VLAN ID    MAC    Port    Inserted" << endl;
     for (auto & elem : vlanHLMACTable) {
         HLMACTable *table = elem.second;
         for (auto & table_j : *table)
-            EV << table_j.second.vid << "   " << table_j.first << "   " << table_j.second.portno << "   " << table_j.second.insertionTime << endl;
+            IOTORII_EV(TABLE) << table_j.second.vid << "   " << table_j.first << "   " << table_j.second.portno << "   " << table_j.second.insertionTime << endl;
     }
 }
 
@@ -229,33 +322,45 @@ void HLMACAddressTable::removeAgedEntriesFromVlan(unsigned int vid)
     HLMACTable *table = getTableForVid(vid);
     if (table == nullptr)
         return;
-    // TODO: this part could be factored out
-    for (auto iter = table->begin(); iter != table->end(); ) {
-        auto cur = iter++;    // iter will get invalidated after erase()
-        AddressEntry& entry = cur->second;
-        if (entry.insertionTime + agingTime <= simTime()) {
-            EV << "Removing aged entry from Address Table: "
+    // aged entries are at the front of agingList
+    for (auto iter = agingList.begin(); (iter != agingList.end()) && isAged((*iter)->entry->second); ) {
+        auto cur = (*iter++)->entry;    // iter will get invalidated after erase()
+        if (cur->second.vid == vid) {
+            IOTORII_EV(TABLE) << "Removing aged entry from Address Table: "
                << cur->first << " --> port" << cur->second.portno << "\n";
-            table->erase(cur);
+            eraseEntry(table, cur);
         }
     }
 }
 
 void HLMACAddressTable::removeAgedEntriesFromAllVlans()
 {
-    for (auto & elem : vlanHLMACTable) {
-        HLMACTable *table = elem.second;
-        // TODO: this part could be factored out
-        for (auto j = table->begin(); j != table->end(); ) {
-            auto cur = j++;    // iter will get invalidated after erase()
-            AddressEntry& entry = cur->second;
-            if (entry.insertionTime + agingTime <= simTime()) {
-                EV << "Removing aged entry from Address Table: "
-                   << cur->first << " --> port" << cur->second.portno << "\n";
-                table->erase(cur);
-            }
-        }
+    Enter_Method_Silent();
+    // aged entries are at the front of agingList
+    while (!agingList.empty() && isAged(agingList.front()->entry->second)) {
+        auto cur = agingList.front()->entry;
+        IOTORII_EV(TABLE) << "Removing aged entry from Address Table: "
+           << cur->first << " --> port" << cur->second.portno << "\n";
+        eraseEntry(getTableForVid(cur->second.vid), cur);
     }
+    scheduleAgingTimer();
+}
+
+void HLMACAddressTable::scheduleAgingTimer()
+{
+    if (agingList.empty()) {
+        cancelEvent(agingTimer);
+        return;
+    }
+    simtime_t expiryTime = agingList.front()->entry->second.insertionTime + agingTime;
+    if (expiryTime < simTime())
+        expiryTime = simTime();
+    if (agingTimer->isScheduled()) {
+        if (agingTimer->getArrivalTime() == expiryTime)
+            return;
+        cancelEvent(agingTimer);
+    }
+    scheduleAt(expiryTime, agingTimer);
 }
 
 void HLMACAddressTable::removeAgedEntriesIfNeeded()
@@ -270,27 +375,49 @@ void HLMACAddressTable::removeAgedEntriesIfNeeded()
 
 void HLMACAddressTable::clearTable()
 {
+    Enter_Method_Silent();
+
+    if (mayHaveListeners(hlmacRemovedSignal)) {
+        for (auto & elem : vlanHLMACTable)
+            for (auto & entry : *elem.second) {
+                HLMACAddressDetails details(entry.first);
+                emit(hlmacRemovedSignal, simTime(), &details);
+            }
+    }
     for (auto & elem : vlanHLMACTable)
         delete elem.second;
+    for (auto & elem : vlanPrefixTrie)
+        delete elem.second;
 
     vlanHLMACTable.clear();
+    vlanPrefixTrie.clear();
+    agingList.clear();
+    if (agingTimer != nullptr)
+        cancelEvent(agingTimer);
     hlmacTable = nullptr;
 }
 
 HLMACAddressTable::~HLMACAddressTable()
 {
+    cancelAndDelete(agingTimer);
     for (auto & elem : vlanHLMACTable)
         delete elem.second;
+    for (auto & elem : vlanPrefixTrie)
+        delete elem.second;
 }
 
 void HLMACAddressTable::setAgingTime(simtime_t agingTime)
 {
+    Enter_Method_Silent();
     this->agingTime = agingTime;
+    scheduleAgingTimer();
 }
 
 void HLMACAddressTable::resetDefaultAging()
 {
+    Enter_Method_Silent();
     agingTime = par("agingTime");
+    scheduleAgingTimer();
 }
 
 bool HLMACAddressTable::isPortInTable(int portno, unsigned int vid)
@@ -312,24 +439,39 @@ bool HLMACAddressTable::isPortInTable(int portno, unsigned int vid)
 HLMACAddress HLMACAddressTable::getlongestMatchedPrefix(HLMACAddress address, unsigned int vid)
 {
     HLMACTable *table = getTableForVid(vid);
-        if (table == nullptr)
-            return HLMACAddress::UNSPECIFIED_ADDRESS;
-        address.removeLastId(); //an address is not prefix of itself
-
-        while(address.getHLMACLength() > 0){
-            auto iter = table->find(address);
-            if (iter != table->end()) {
-                if (iter->second.insertionTime + agingTime <= simTime()) {
-                    // don't use (and throw out) aged entries
-                    EV << "Ignoring and deleting aged entry: " << iter->first << " --> port" << iter->second.portno << "\n";
-                    table->erase(iter);
-                }else
-                    return address;
-            }
-            address.removeLastId();
-        }//while
+    TrieNode *root = getTrieForVid(vid);
+    if ((table == nullptr) || (root == nullptr) || (address.getHLMACLength() == 0))
+        return HLMACAddress::UNSPECIFIED_ADDRESS;
+    unsigned int maxLength = address.getHLMACLength() - 1; //an address is not prefix of itself
+
+    // one walk down the trie, remembering the deepest entry which is not aged (agingTimer throws aged entries out)
+    unsigned int matchedLength = 0;
+    TrieNode *node = root;
+    for (unsigned int i = 0; i < maxLength; i++) {
+        auto child = node->children.find(address.getIndexValue(i));
+        if (child == node->children.end())
+            break;
+        node = child->second;
+        if (node->hasEntry && !isAged(node->entry->second))
+            matchedLength = i + 1;
+    }
 
+    if (matchedLength == 0)
         return HLMACAddress::UNSPECIFIED_ADDRESS;
+    while (address.getHLMACLength() > matchedLength)
+        address.removeLastId();
+    return address;
+}
+
+bool HLMACAddressTable::isMyAddress(HLMACAddress address, unsigned int vid)
+{
+    HLMACTable *table = getTableForVid(vid);
+    if (table == nullptr)
+        return false;
+
+    auto iter = findEntry(table, address, vid);
+    // don't use aged entries, agingTimer throws them out
+    return (iter != table->end()) && !isAged(iter->second);
 }
 
 unsigned int HLMACAddressTable::getNumberOfAddresses(unsigned int vid)
@@ -354,22 +496,49 @@ HLMACAddress HLMACAddressTable::getAddress(unsigned int addressIndex, unsigned i
 //Used for hopCount metric
 int HLMACAddressTable::getMinHopCount(HLMACAddress dstAddress, unsigned int vid)
 {
-    //EV << "-->HLMACAddressTable::getMinHopCount()" << endl;
+    //IOTORII_EV(TABLE) << "-->HLMACAddressTable::getMinHopCount()" << endl;
 
     int minHopCount = -1;
-    int hopCount = -1;
-    for (unsigned int i = 0; i < getNumberOfAddresses(vid); i++){
-        hopCount = getAddress(i).numHopsBetweenAddresses(dstAddress);
-        if (minHopCount == -1){
-            minHopCount = hopCount;
-        }else if(hopCount < minHopCount){
+    HLMACTable *table = getTableForVid(vid);
+    if (table == nullptr)
+        return minHopCount;
+
+    // one ordered pass, getAddress(i) would walk the table from its beginning for each i
+    for (auto & elem : *table){
+        int hopCount = elem.first.numHopsBetweenAddresses(dstAddress);
+        if ((minHopCount == -1) || (hopCount < minHopCount))
             minHopCount = hopCount;
-        }
     }
-    //EV << "hopCount = " << hopCount << "minHopCount = " << minHopCount << endl;
+    //IOTORII_EV(TABLE) << "minHopCount = " << minHopCount << endl;
 
     return minHopCount;
 }
 
+//Used for hopCount metric
+int HLMACAddressTable::getMinHopCount(const std::vector<HLMACAddress>& addresses, const std::vector<HLMACAddress>& dstAddresses)
+{
+    int minHopCount = -1;
+    for (auto & dstAddress : dstAddresses){
+        for (auto & address : addresses){
+            int hopCount = address.numHopsBetweenAddresses(dstAddress);
+            if ((minHopCount == -1) || (hopCount < minHopCount))
+                minHopCount = hopCount;
+        }
+    }
+    return minHopCount;
+}
+
+//Used for hopCount metric
+void HLMACAddressTable::getAddresses(std::vector<HLMACAddress>& addresses, unsigned int vid)
+{
+    HLMACTable *table = getTableForVid(vid);
+    if (table == nullptr)
+        return;
+
+    addresses.reserve(addresses.size() + table->size());
+    for (auto & elem : *table)
+        addresses.push_back(elem.first);
+}
+
 } // namespace iotorii
 
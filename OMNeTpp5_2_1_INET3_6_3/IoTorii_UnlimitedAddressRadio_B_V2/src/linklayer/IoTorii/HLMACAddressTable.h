@@ -46,6 +46,8 @@
 #include "../IoTorii/IHLMACAddressTable.h"
 #include "src/linklayer/common/HLMACAddress.h"
 
+#include <list>
+
 namespace iotorii {
 using namespace inet;
 
@@ -75,10 +77,38 @@ class HLMACAddressTable : public cSimpleModule, public IHLMACAddressTable
     typedef std::map<HLMACAddress, AddressEntry, MAC_compare> HLMACTable;
     typedef std::map<unsigned int, HLMACTable *> VlanHLMACTable;
 
+    /**
+     * Node of the prefix trie kept next to each HLMACTable. The path from the root
+     * spells the IDs of an address without its trailing zeros (compareTo() ignores them),
+     * so getlongestMatchedPrefix() needs one walk and no HLMACAddress copies. It is the only
+     * prefix query: nothing in IoTorii asks whether an address is a prefix of one of the
+     * node's addresses, or for an address under a given prefix.
+     */
+    struct TrieNode
+    {
+        TrieNode *parent = nullptr;
+        unsigned int id = 0;    // ID of the edge from parent
+        std::map<unsigned int, TrieNode *> children;
+        bool hasEntry = false;
+        HLMACTable::iterator entry;    // table entry of this address, valid if hasEntry
+        unsigned int numEntries = 0;    // number of table entries in this subtree
+        std::list<TrieNode *>::iterator agingPos;    // position in agingList, valid if hasEntry
+        TrieNode() {}
+        TrieNode(TrieNode *parent, unsigned int id) : parent(parent), id(id) {}
+        ~TrieNode() { for (auto & elem : children) delete elem.second; }
+    };
+    typedef std::map<unsigned int, TrieNode *> VlanPrefixTrie;
+    typedef std::list<TrieNode *> AgingList;
+
     simtime_t agingTime;    // Max idle time for address table entries
     simtime_t lastPurge;    // Time of the last call of removeAgedEntriesFromAllVlans()
     HLMACTable *hlmacTable = nullptr;    // VLAN-unaware address lookup (vid = 0)
     VlanHLMACTable vlanHLMACTable;    // VLAN-aware address lookup
+    VlanPrefixTrie vlanPrefixTrie;    // Prefix index of each table in vlanHLMACTable
+    AgingList agingList;    // Entries of all VLANs, oldest insertionTime first (all entries share agingTime)
+    cMessage *agingTimer = nullptr;    // Scheduled when the front of agingList ages
+
+    static simsignal_t hlmacRemovedSignal;    // see IoToriiSignals.h
 
   protected:
 
@@ -90,6 +120,43 @@ class HLMACAddressTable : public cSimpleModule, public IHLMACAddressTable
      */
     HLMACTable *getTableForVid(unsigned int vid);
 
+    /**
+     * @brief Returns the prefix trie root for a specified VLAN ID, nullptr if it does not exist and create is false
+     */
+    TrieNode *getTrieForVid(unsigned int vid, bool create = false);
+
+    /**
+     * @brief Number of IDs of address without its trailing zeros, i.e. its depth in the trie
+     */
+    static unsigned int getTrieLength(const HLMACAddress& address);
+
+    /**
+     * @brief Returns the trie node of the first length IDs of address, or nullptr
+     */
+    TrieNode *findTrieNode(TrieNode *root, const HLMACAddress& address, unsigned int length);
+
+    /**
+     * @brief Exact lookup of address in table, returns table->end() if not found
+     */
+    virtual HLMACTable::iterator findEntry(HLMACTable *table, const HLMACAddress& address, unsigned int vid);
+
+    /**
+     * @brief Adds a new table entry to the prefix trie
+     */
+    virtual void insertEntry(HLMACTable::iterator iter);
+
+    /**
+     * @brief Removes an entry from both the table and the prefix trie, emits hlmacRemoved
+     */
+    virtual void eraseEntry(HLMACTable *table, HLMACTable::iterator iter);
+
+    bool isAged(const AddressEntry& entry) { return entry.insertionTime + agingTime <= simTime(); }
+
+    /**
+     * @brief (Re)schedules agingTimer for the oldest entry, the only place where aged entries are removed
+     */
+    void scheduleAgingTimer();
+
   public:
 
     HLMACAddressTable();
@@ -159,6 +226,8 @@ class HLMACAddressTable : public cSimpleModule, public IHLMACAddressTable
     //EXTRA BEGIN
     virtual HLMACAddress getlongestMatchedPrefix(HLMACAddress hlmac, unsigned int vid = 0) override;
 
+    virtual bool isMyAddress(HLMACAddress address, unsigned int vid = 0) override;
+
     virtual unsigned int getNumberOfAddresses(unsigned int vid = 0) override;
 
     //Used for hopCount metric
@@ -167,6 +236,13 @@ class HLMACAddressTable : public cSimpleModule, public IHLMACAddressTable
     //Used for hopCount metric
     virtual int getMinHopCount(HLMACAddress dstAddress, unsigned int vid) override;
 
+    //Used for hopCount metric
+    virtual void getAddresses(std::vector<HLMACAddress>& addresses, unsigned int vid = 0) override;
+
+    //Used for hopCount metric, getMinHopCount() of a table with the given addresses (e.g. reported by the hlmacAssigned signal)
+    //for each of dstAddresses, -1 if either is empty. One pass over addresses per destination, no temporary address
+    static int getMinHopCount(const std::vector<HLMACAddress>& addresses, const std::vector<HLMACAddress>& dstAddresses);
+
     //EXTRA END
 
 };
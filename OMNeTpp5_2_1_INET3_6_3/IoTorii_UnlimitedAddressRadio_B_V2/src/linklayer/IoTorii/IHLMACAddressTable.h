@@ -116,6 +116,9 @@ class IHLMACAddressTable
     //EXTRA BEGIN
     virtual HLMACAddress getlongestMatchedPrefix(HLMACAddress hlmac, unsigned int vid = 0) = 0;
 
+    //true if address is in the table (not aged), the entries of this node have no port, so getPortForAddress() cannot tell
+    virtual bool isMyAddress(HLMACAddress address, unsigned int vid = 0) = 0;
+
     virtual unsigned int getNumberOfAddresses(unsigned int vid = 0) = 0;
 
     //Used for hopCount metric
@@ -124,6 +127,9 @@ class IHLMACAddressTable
     //Used for hopCount metric
     virtual int getMinHopCount(HLMACAddress dstAddress, unsigned int vid = 0) = 0;
 
+    //Used for hopCount metric, appends all addresses of the table (in table order) to addresses
+    virtual void getAddresses(std::vector<HLMACAddress>& addresses, unsigned int vid = 0) = 0;
+
     //EXTRA END
 
 };
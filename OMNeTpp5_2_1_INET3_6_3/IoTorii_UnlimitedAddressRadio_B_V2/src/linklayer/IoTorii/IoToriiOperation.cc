@@ -30,21 +30,27 @@
 #include "inet/linklayer/ethernet/Ethernet.h"
 #include "src/linklayer/common/eGA3Frame.h"
 #include "src/linklayer/common/HLMACAddress.h"
+#include "src/linklayer/common/IoToriiLog.h"
 #include <vector>
+#include <algorithm>
 
 #include "src/linklayer/IoTorii/HLMACAddressTable.h"
 #include "inet/linklayer/common/SimpleLinkLayerControlInfo.h"
 
-#include "src/statisticcollector/StatisticCollector.h"
-
 
 namespace iotorii {
 using namespace inet;
 
 Define_Module(IoToriiOperation);
 
+simsignal_t IoToriiOperation::coreStartedSignal = registerSignal("coreStarted");
+simsignal_t IoToriiOperation::hlmacAssignedSignal = registerSignal("hlmacAssigned");
+simsignal_t IoToriiOperation::setHLMACReceivedSignal = registerSignal("setHLMACReceived");
+simsignal_t IoToriiOperation::helloSentSignal = registerSignal("helloSent");
+simsignal_t IoToriiOperation::setHLMACSentSignal = registerSignal("setHLMACSent");
+simsignal_t IoToriiOperation::neighborAddedSignal = registerSignal("neighborAdded");
+
 IoToriiOperation::IoToriiOperation() :
-    statisticCollector(nullptr),
     headerLength(0),
     headerLengthPANID(0),
     broadcastType(0),
@@ -57,6 +63,8 @@ IoToriiOperation::IoToriiOperation() :
     startCoreEvent(nullptr),
     coreInterval(0),
     coreStartTime(0),
+    coreQuietPeriod(0),
+    coreLatestStartTime(0),
     numReceivedLowerPacket(0),
     numReceivedUpperPacket(0),
     numDiscardedFrames(0),
@@ -66,6 +74,7 @@ IoToriiOperation::IoToriiOperation() :
     numDiscardedBroadcastFrames(0),
     numHelloRcvd(0),
     numHelloSent(0),
+    numHelloSuppressed(0),
     numAllowedNeighbors(0),
     numNeighbors(0),
     numDiscardedNoHLMAC(0),
@@ -74,11 +83,30 @@ IoToriiOperation::IoToriiOperation() :
     numHLMACRcvd(0),
     numHLMACAssigned(0),
     numHLMACLoopable(0),
+    numHLMACRefreshed(0),
     numHLMACSent(0),
+    numTrickleSuppressed(0),
+    setHLMACPayloadBytes(0),
+    setHLMACPayloadBytesWithMACs(0),
     maxNeighbors(0),
     maxHLMACs(-1),
+    shortIdLength(0),
+    aggregateSetHLMAC(false),
+    sendSetHLMACTimer(nullptr),
+    useTrickle(false),
+    trickleK(1),
+    trickleMaxIntervals(0),
+    trickleTransmitTimer(nullptr),
+    trickleIntervalTimer(nullptr),
     hlmacTable(nullptr),
+    checkHLMACCount(false),
     HelloTimer(nullptr),
+    passiveNeighborDiscovery(false),
+    helloMaxRetries(0),
+    lastHelloTime(-1),
+    reofferSetHLMACTimer(nullptr),
+    isHeard(false),
+    announceTime(-1),
     helloStartTime(0),
     helloInterval(0),
     isOperational(false),
@@ -103,9 +131,35 @@ void IoToriiOperation::initialize(int stage)
 
         helloStartTime = par("helloStartTime");
         helloInterval = par("helloInterval");
+        maxJitter = par("maxJitter");
+        passiveNeighborDiscovery = par("passiveNeighborDiscovery");
+        helloMaxRetries = par("helloMaxRetries");
+        if (helloMaxRetries < 0)
+            throw cRuntimeError("helloMaxRetries must not be negative");
 
         maxHLMACs = par("maxHLMACs");
 
+        int shortIdLengthPar = par("shortIdLength");
+        if ((shortIdLengthPar < 0) || (shortIdLengthPar > 48))
+            throw cRuntimeError("shortIdLength must be between 0 and 48 bits");
+        shortIdLength = shortIdLengthPar;
+
+        aggregateSetHLMAC = par("aggregateSetHLMAC");
+        checkHLMACCount = par("checkHLMACCount");
+
+        useTrickle = par("useTrickle");
+        if (useTrickle){
+            trickleImin = par("trickleImin");
+            int doublings = par("trickleImaxDoublings");
+            trickleK = par("trickleK");
+            trickleMaxIntervals = par("trickleMaxIntervals");
+            if ((trickleImin <= 0) || (doublings < 0) || (trickleK < 0) || (trickleMaxIntervals < 0))
+                throw cRuntimeError("trickleImin must be positive, trickleImaxDoublings, trickleK and trickleMaxIntervals must not be negative");
+            trickleImax = trickleImin * pow(2, doublings);
+            WATCH(trickleInterval);
+            WATCH(numTrickleSuppressed);
+        }
+
         maxNeighbors = pow(2, sizeof(unsigned int) * 8) - 1;  //Type of address width is Unsigned int in this simulation
 
         jitterPar = &par("jitter");
@@ -129,6 +183,7 @@ void IoToriiOperation::initialize(int stage)
         WATCH(numHLMACRcvd);
         WATCH(numHLMACAssigned);
         WATCH(numHLMACLoopable);
+        WATCH(numHLMACRefreshed);
         WATCH(numHLMACSent);
         WATCH(numDiscardedNoHLMAC);
 
@@ -148,22 +203,33 @@ void IoToriiOperation::initialize(int stage)
         myMACAddress = check_and_cast<SimpleIdealWirelessMAC *>(getParentModule()->getSubmodule("simpleidealwirelessMAC"))->getMACAddress();
         corePrefix = par("corePrefix");
 
-        statisticCollector = check_and_cast<StatisticCollector *>(getSimulation()->getSystemModule()->getSubmodule("statisticCollector"));
-
         HelloTimer = new cMessage("HelloTimer");
-        scheduleAt(helloStartTime, HelloTimer); //Next Hello broadcasting
+        if (passiveNeighborDiscovery){
+            if (!useTrickle)
+                reofferSetHLMACTimer = new cMessage("reofferSetHLMACTimer");
+        }
+        else
+            scheduleAt(helloStartTime, HelloTimer); //Next Hello broadcasting
+
+        if (useTrickle){
+            trickleTransmitTimer = new cMessage("trickleTransmitTimer");
+            trickleIntervalTimer = new cMessage("trickleIntervalTimer");
+        }
+        else if (aggregateSetHLMAC)
+            sendSetHLMACTimer = new cMessage("sendSetHLMACTimer");
 
         if (isCoreSwitch = par("isCoreSwitch"))
         {
-            EV<< "This switch is a core switch and its prefix is  "<< corePrefix << "\n";
+            IOTORII_EV(OPERATION)<< "This switch is a core switch and its prefix is  "<< corePrefix << "\n";
             startCoreEvent = new cMessage("startCoreEvent");
             coreStartTime = par("coreStartTime");
             coreInterval = par("coreInterval");
-            simtime_t startTime = simTime() + coreStartTime;
-            scheduleAt(startTime, startCoreEvent);
-            statisticCollector->startStatistics(myMACAddress, startTime);
+            coreQuietPeriod = par("coreQuietPeriod");
+            coreLatestStartTime = simTime() + coreStartTime;
+            scheduleAt(coreLatestStartTime, startCoreEvent);
 
             WATCH(coreStartTime);
+            WATCH(coreQuietPeriod);
             WATCH(corePrefix);
 
         }
@@ -171,89 +237,176 @@ void IoToriiOperation::initialize(int stage)
 /*
        //Testing HLMACAddress and eGA3 frame data structure
 
-        EV << "unspecified   " << HLMACAddress::UNSPECIFIED_ADDRESS << endl;
-        EV << "broadcast     " << HLMACAddress::BROADCAST_ADDRESS << endl;
+        IOTORII_EV(OPERATION) << "unspecified   " << HLMACAddress::UNSPECIFIED_ADDRESS << endl;
+        IOTORII_EV(OPERATION) << "broadcast     " << HLMACAddress::BROADCAST_ADDRESS << endl;
         int array[8] = {0,0,0,0,0,0,0,0};
 
-        EV << "size of " << sizeof array << "   " << sizeof array[0] << endl;
+        IOTORII_EV(OPERATION) << "size of " << sizeof array << "   " << sizeof array[0] << endl;
         HLMACAddress a;
-        EV << "hlmac test is  " << a << endl;
+        IOTORII_EV(OPERATION) << "hlmac test is  " << a << endl;
         a.setCore(1);
-        EV << "1              " << a << endl;
+        IOTORII_EV(OPERATION) << "1              " << a << endl;
         a.removeLastId();
-        EV << "empty vector!  " << a << "size vector " << a.getHLMACLength() << endl;
+        IOTORII_EV(OPERATION) << "empty vector!  " << a << "size vector " << a.getHLMACLength() << endl;
         a.addNewId(2);
-        EV << "2              " << a << endl;
+        IOTORII_EV(OPERATION) << "2              " << a << endl;
         a.addNewId(250);
         a.addNewId(300);
         a.addNewId(400);
         a.addNewId(50);
-        EV << "250 300 400 50 " << a << endl;
+        IOTORII_EV(OPERATION) << "250 300 400 50 " << a << endl;
         a.removeLastId();
-        EV << "delete last id " << a << endl;
+        IOTORII_EV(OPERATION) << "delete last id " << a << endl;
         eGA3Frame b;
-        EV << "eGA3 0         " << b << endl;
+        IOTORII_EV(OPERATION) << "eGA3 0         " << b << endl;
         eGA3Frame c(2,a);
-        EV << "eGA3 hlmac     " << c << endl;
+        IOTORII_EV(OPERATION) << "eGA3 hlmac     " << c << endl;
 */
 }
 
 void IoToriiOperation::sendAndScheduleHello()
 {
-    EV << "->IoToriiOperation::sendAndScheduleHello()" << endl;
+    IOTORII_EV(OPERATION) << "->IoToriiOperation::sendAndScheduleHello()" << endl;
 
     //scheduling next Hello packet
     helloStartTime+= helloInterval;
     //scheduleAt(helloStartTime, HelloTimer); //Next Hello broadcasting
 
-    MACFrameBase *macPkt = new MACFrameBase("Hello!");
+    if (passiveNeighborDiscovery){
+        //a reply is needless once this node has an address, its own SetHLMAC frames make it known
+        if (isHeard || (hlmacTable->getNumberOfAddresses() > 0)){
+            numHelloSuppressed++;
+            IOTORII_EV(OPERATION) << "Hello message is not sent, this node has an address." << endl;
+            IOTORII_EV(OPERATION) << "<-IoToriiOperation::sendAndScheduleHello()" << endl;
+            return;
+        }
+    }
+
+    MACFrameBase *macPkt = new MACFrameBase("Hello!", IOTORII_HELLO);
     macPkt->setDestAddr(MACAddress::BROADCAST_ADDRESS);
     macPkt->setBitLength(headerLength);
-    EV << "Hello message from this node is broadcasted to all node in the range. " << endl;
+    IOTORII_EV(OPERATION) << "Hello message from this node is broadcasted to all node in the range. " << endl;
     double delay = jitterPar->doubleValue();
-    EV << "value of random jitter is " << delay << endl;
+    IOTORII_EV(OPERATION) << "value of random jitter is " << delay << endl;
     sendDown(macPkt, delay); //send(macPkt, lowerLayerOutGateId);  //send(macPkt, "lowerLayerOut");
     numHelloSent++;
+    emit(helloSentSignal, 1L);
+    lastHelloTime = simTime();
+    updateAnnounceTime(delay);
 
-    EV << "<-IoToriiOperation::sendAndScheduleHello()" << endl;
+    IOTORII_EV(OPERATION) << "<-IoToriiOperation::sendAndScheduleHello()" << endl;
+}
+
+bool IoToriiOperation::addNeighbor(const MACAddress& src)
+{
+    for (auto & neighbor : neighborList)
+        if (neighbor == src)
+            return false;
+
+    neighborList.push_back(src);
+    numNeighbors++;
+    if (numNeighbors <= maxNeighbors)
+        numAllowedNeighbors++;
+    emit(neighborAddedSignal, (long)(numNeighbors <= maxNeighbors));
+    //adaptive core start: the core waits until its neighbor table has been stable for coreQuietPeriod
+    if (isCoreSwitch && (coreQuietPeriod > 0) && startCoreEvent->isScheduled()){
+        cancelEvent(startCoreEvent);
+        scheduleAt(std::min(simTime() + coreQuietPeriod, coreLatestStartTime), startCoreEvent);
+        IOTORII_EV(OPERATION) << "New neighbor, the core starts at " << startCoreEvent->getArrivalTime() << endl;
+    }
+    //Trickle: a new neighbor has not been offered the addresses of this node yet
+    if (useTrickle && !tricklePrefixes.empty()){
+        for (auto & tricklePrefix : tricklePrefixes){
+            tricklePrefix.numIntervals = 0;
+            tricklePrefix.isSent = false;
+        }
+        resetTrickle();
+    }
+    return true;
+}
+
+void IoToriiOperation::scheduleHelloReply()
+{
+    //the core is known from its own SetHLMAC frames
+    if (isCoreSwitch || (hlmacTable->getNumberOfAddresses() > 0) || HelloTimer->isScheduled() || (numHelloSent > helloMaxRetries))
+        return;
+    simtime_t helloTime = (lastHelloTime < 0) ? simTime() : std::max(simTime(), lastHelloTime + helloInterval);
+    scheduleAt(helloTime, HelloTimer);
+    IOTORII_EV(OPERATION) << "The sender of the SetHLMAC frame does not know this node, a Hello is sent at " << helloTime << endl;
 }
 
 void IoToriiOperation::startCore(int core)
 {
-    EV << "->IoToriiOperation::startCore()" << endl;
+    IOTORII_EV(OPERATION) << "->IoToriiOperation::startCore()" << endl;
 
     //scheduling next Core event
     coreStartTime = coreStartTime + coreInterval;
     //scheduleAt(coreStartTime, startCoreEvent);
 
+    //convergence time is measured from here, whether the core started at coreStartTime or after its quiet period
+    emit(coreStartedSignal, simTime());
+
     //preparing SetHLMAC frame
     HLMACAddress coreAddress;             // create HLMAC
     coreAddress.setCore((unsigned int)core);  //insert core prefix in it
-    EV << "Core address " << coreAddress << " is assigned to this node." << endl;
+    IOTORII_EV(OPERATION) << "Core address " << coreAddress << " is assigned to this node." << endl;
     saveHLMAC(coreAddress);     //assigns coreAddress to itself
 
     sendToNeighbors(coreAddress);
 
-    EV << "<-IoToriiOperation::startCore()" << endl;
+    IOTORII_EV(OPERATION) << "<-IoToriiOperation::startCore()" << endl;
 }
 
 void IoToriiOperation::sendToNeighbors(HLMACAddress prefix)
 {
-    EV << "->IoToriiOperation::sendToNeighbors()" << endl;
+    IOTORII_EV(OPERATION) << "->IoToriiOperation::sendToNeighbors()" << endl;
+
+    if (reofferSetHLMACTimer)
+        offeredPrefixes.push_back(prefix);
+
+    if (useTrickle){
+        IOTORII_EV(OPERATION) << "Prefix " << prefix << " is new, the Trickle interval is reset" << endl;
+        TricklePrefix tricklePrefix = {prefix, 0, 0, false};
+        tricklePrefixes.push_back(tricklePrefix);
+        resetTrickle();
+    }
+    else if (aggregateSetHLMAC){
+        pendingPrefixes.push_back(prefix);
+        if (!sendSetHLMACTimer->isScheduled()){
+            double delay = jitterPar->doubleValue();
+            IOTORII_EV(OPERATION) << "value of random jitter is " << delay << endl;
+            scheduleAt(simTime() + delay, sendSetHLMACTimer);
+        }
+        IOTORII_EV(OPERATION) << "Prefix " << prefix << " is added to the pending SetHLMAC frame, number of pending prefixes is " << pendingPrefixes.size() << endl;
+    }
+    else{
+        double delay = jitterPar->doubleValue();
+        IOTORII_EV(OPERATION) << "value of random jitter is " << delay << endl;
+        sendSetHLMAC(std::vector<HLMACAddress>(1, prefix), delay);
+    }
+
+    IOTORII_EV(OPERATION) << "<-IoToriiOperation::sendToNeighbors()" << endl;
+}
+
+void IoToriiOperation::sendSetHLMAC(const std::vector<HLMACAddress>& prefixes, double delay)
+{
+    IOTORII_EV(OPERATION) << "->IoToriiOperation::sendSetHLMAC()" << endl;
 
     unsigned int numSuffixes = 0;
 
-    EV << "This node has " << numNeighbors << " neighbors, " << "maximum number of allowed neighbors is " << maxNeighbors << endl;
+    IOTORII_EV(OPERATION) << "This node has " << numNeighbors << " neighbors, " << "maximum number of allowed neighbors is " << maxNeighbors << endl;
     if (numNeighbors > maxNeighbors){
         hlmacWidthIsLow++;
         numSuffixes = maxNeighbors;
-        EV << "hlmacWidthIsLow is " << hlmacWidthIsLow << endl;
+        IOTORII_EV(OPERATION) << "hlmacWidthIsLow is " << hlmacWidthIsLow << endl;
     }else
         numSuffixes = numNeighbors;
 
     //preparing frame payload
-    SetHLMACFrame *SetHLMACFramePayload = new SetHLMACFrame ("SetHLMAC");
-    SetHLMACFramePayload->setPrefix(prefix);
+    SetHLMACFrame *SetHLMACFramePayload = new SetHLMACFrame ("SetHLMAC", IOTORII_SETHLMAC);
+    SetHLMACFramePayload->setPrefixesArraySize(prefixes.size());
+    for (unsigned int i = 0; i < prefixes.size(); i++)
+        SetHLMACFramePayload->setPrefixes(i, prefixes[i]);
     SetHLMACFramePayload->setTargetOptionsArraySize(numSuffixes);
     //SetHLMACFrame->setBitLength(numSuffixes * 8 + 8);  //numSuffixes * sizeof suffix + size of prefix
     TargetOption targetOption;
@@ -261,108 +414,192 @@ void IoToriiOperation::sendToNeighbors(HLMACAddress prefix)
     for (int i = 0; i < numSuffixes; i++) {  //Second condition is related on the width of HLMACAddress, 3 bits allowed 3 neighbor, 00 is reserved for NOTSPECIFIED address
         targetOption.MAC = neighborList.at(i);
         targetOption.suffix = i+1;
-        EV << "Prefix " << SetHLMACFramePayload->getPrefix() << " and Suffix " << targetOption.suffix << " for neighbor with MAC address " << targetOption.MAC << " is added to the target option"<< endl;
+        IOTORII_EV_DEBUG(OPERATION) << "Prefixes " << prefixes.size() << " and Suffix " << targetOption.suffix << " for neighbor with MAC address " << targetOption.MAC << " is added to the target option"<< endl;
         SetHLMACFramePayload->setTargetOptions(i, targetOption);
     }
+    SetHLMACFramePayload->setShortIdLength(shortIdLength);
+    SetHLMACFramePayload->indexTargetOptions(neighborList);  //falls back to MAC addresses if two neighbors have the same short ID
+    SetHLMACFramePayload->setBitLength(SetHLMACFramePayload->getPayloadBitLength(SetHLMACFramePayload->getShortIdLength()));
+    setHLMACPayloadBytes += SetHLMACFramePayload->getByteLength();
+    setHLMACPayloadBytesWithMACs += (SetHLMACFramePayload->getPayloadBitLength(0) + 7) / 8;
 
     //preparing MAC frame
-    MACFrameBase *SetHLMACFrame = new MACFrameBase ("SetHLMAC");
+    MACFrameBase *SetHLMACFrame = new MACFrameBase ("SetHLMAC", IOTORII_SETHLMAC);
     SetHLMACFrame->setDestAddr(MACAddress::BROADCAST_ADDRESS);
+    SetHLMACFrame->setBitLength(headerLength);
     SetHLMACFrame->encapsulate(SetHLMACFramePayload);
 
-    double delay = jitterPar->doubleValue();
-    EV << "value of random jitter is " << delay << endl;
-    EV << "SetHLMAC frame " << SetHLMACFrame->getName() << " is sent to the MAC layer to send to the neighbors" << endl;
+    IOTORII_EV(OPERATION) << "SetHLMAC frame " << SetHLMACFrame->getName() << " with " << prefixes.size() << " prefixes is sent to the MAC layer to send to the neighbors" << endl;
     emit(LayeredProtocolBase::packetSentToLowerSignal, SetHLMACFrame);
     sendDown(SetHLMACFrame, delay);  //send(dupFrame, lowerLayerOutGateId);  // send(dupFrame, "lowerLayerOut");
     numHLMACSent++;
+    emit(setHLMACSentSignal, 1L);
+    isHeard = true;
+    updateAnnounceTime(delay);
 
-    EV << "<-IoToriiOperation::sendToNeighbors()" << endl;
+    IOTORII_EV(OPERATION) << "<-IoToriiOperation::sendSetHLMAC()" << endl;
+}
+
+void IoToriiOperation::startTrickleInterval()
+{
+    for (auto & tricklePrefix : tricklePrefixes)
+        tricklePrefix.counter = 0;
+    cancelEvent(trickleTransmitTimer);
+    cancelEvent(trickleIntervalTimer);
+    scheduleAt(simTime() + uniform(trickleInterval / 2, trickleInterval), trickleTransmitTimer);
+    scheduleAt(simTime() + trickleInterval, trickleIntervalTimer);
+    IOTORII_EV_DEBUG(OPERATION) << "Trickle interval " << trickleInterval << " started, transmission at " << trickleTransmitTimer->getArrivalTime() << endl;
+}
+
+void IoToriiOperation::resetTrickle()
+{
+    //RFC 6206, 4.2 step 6: nothing to do if I is already Imin
+    if ((trickleInterval == trickleImin) && trickleIntervalTimer->isScheduled())
+        return;
+    trickleInterval = trickleImin;
+    startTrickleInterval();
+}
+
+void IoToriiOperation::handleTrickleTransmitTimer()
+{
+    std::vector<HLMACAddress> prefixes;
+    for (auto it = tricklePrefixes.begin(); it != tricklePrefixes.end(); ){
+        if (!hlmacTable->isMyAddress(it->prefix)){
+            it = tricklePrefixes.erase(it);  //removed from the HLMAC table (aging, flush)
+            continue;
+        }
+        TricklePrefix& tricklePrefix = *it++;
+        if ((trickleMaxIntervals != 0) && (tricklePrefix.numIntervals >= trickleMaxIntervals))
+            continue;
+        tricklePrefix.numIntervals++;
+        if (tricklePrefix.isSent && (trickleK != 0) && (tricklePrefix.counter >= trickleK)){
+            numTrickleSuppressed++;
+            IOTORII_EV(OPERATION) << "Prefix " << tricklePrefix.prefix << " is suppressed, " << tricklePrefix.counter << " consistent SetHLMAC frames were heard" << endl;
+            continue;
+        }
+        tricklePrefix.isSent = true;
+        prefixes.push_back(tricklePrefix.prefix);
+    }
+    if (!prefixes.empty())
+        sendSetHLMAC(prefixes, 0);  //t is already random
 }
 
-HLMACAddress IoToriiOperation::extractMyAddress(cPacket *frame){
-    EV << "->IoToriiOperation::extractMyAddress()" << endl;
+bool IoToriiOperation::isTrickleDone()
+{
+    if (trickleMaxIntervals == 0)
+        return false;
+    for (auto & tricklePrefix : tricklePrefixes)
+        if (tricklePrefix.numIntervals < trickleMaxIntervals)
+            return false;
+    return true;
+}
 
-    SetHLMACFrame *SetHLMACFramePayload = check_and_cast<SetHLMACFrame *>(frame->decapsulate());
-    HLMACAddress hlmac;
+void IoToriiOperation::countConsistentPrefixes(const SetHLMACFrame *frame)
+{
+    for (unsigned int i = 0; i < frame->getPrefixesArraySize(); i++){
+        HLMACAddress parent = frame->getPrefixes(i);
+        parent.removeLastId();
+        for (auto & tricklePrefix : tricklePrefixes)
+            if (tricklePrefix.prefix == parent)
+                tricklePrefix.counter++;
+    }
+}
 
-    for(unsigned int i=0; i<SetHLMACFramePayload->getTargetOptionsArraySize(); i++){
-        if (SetHLMACFramePayload->getTargetOptions(i).MAC == myMACAddress){
-            hlmac = SetHLMACFramePayload->getPrefix();
-            hlmac.addNewId(SetHLMACFramePayload->getTargetOptions(i).suffix);
-            delete frame;
-            return hlmac;
+void IoToriiOperation::extractMyAddresses(cPacket *frame, std::vector<HLMACAddress>& addresses){
+    IOTORII_EV(OPERATION) << "->IoToriiOperation::extractMyAddresses()" << endl;
+
+    //read-only access, so the prefixes and targetOptions arrays stay shared with the other receivers
+    const SetHLMACFrame *SetHLMACFramePayload = check_and_cast<SetHLMACFrame *>(frame->decapsulate());
+
+    //the sender checked the short IDs against the neighbors it knew when it built the frame, at most maxJitter before
+    //its arrival, so this node is among them only if its first frame was transmitted before (a node the sender could not
+    //hear, e.g. over an asymmetric link, is never among them, see the shortIdLength parameter)
+    bool isKnownBySender = (announceTime >= 0) && (announceTime + maxJitter < frame->getArrivalTime());
+    int targetOption = (isKnownBySender || (SetHLMACFramePayload->getShortIdLength() == 0)) ? SetHLMACFramePayload->findTargetOption(myMACAddress) : -1;
+    if (targetOption >= 0){
+        unsigned int suffix = SetHLMACFramePayload->getTargetSuffix(targetOption);
+        for (unsigned int i = 0; i < SetHLMACFramePayload->getPrefixesArraySize(); i++){
+            HLMACAddress hlmac = SetHLMACFramePayload->getPrefixes(i);
+            hlmac.addNewId(suffix);
+            addresses.push_back(hlmac);
         }
     }
 
+    delete SetHLMACFramePayload;
     delete frame;
-    return HLMACAddress::UNSPECIFIED_ADDRESS;
 
-    EV << "<-IoToriiOperation::extractMyAddress()" << endl;
+    IOTORII_EV(OPERATION) << "<-IoToriiOperation::extractMyAddresses()" << endl;
 }
 void IoToriiOperation::receiveSetHLMACMessage(HLMACAddress hlmac, simtime_t arrivalTime)
 {
-    if (!hasLoop(hlmac)){
+    if (hlmacTable->isMyAddress(hlmac)){
+        //hasLoop() does not see the address itself, so a known address would be saved and advertised again
+        hlmacTable->updateTableWithAddress(-1, hlmac);
+        numHLMACRefreshed++;
+        IOTORII_EV(OPERATION) << "HLMAC address " << hlmac << " is already assigned to this node, its entry is refreshed." << endl;
+    }
+    else if (!hasLoop(hlmac)){
         bool isSaved = saveHLMAC(hlmac);
         if (isSaved){
-            EV << "HLMAC address " << hlmac << " has assigned to this node." << endl;
-            EV << "Prefix " << hlmac << " is sent to neighbors by this node after creating broadcast SetHLMAC frame." << endl;
-            statisticCollector->nodeJoined(myMACAddress, arrivalTime);
+            IOTORII_EV(OPERATION) << "HLMAC address " << hlmac << " has assigned to this node." << endl;
+            IOTORII_EV(OPERATION) << "Prefix " << hlmac << " is sent to neighbors by this node after creating broadcast SetHLMAC frame." << endl;
             sendToNeighbors(hlmac);
         }
         else{
-            EV << "HLMAC address " << hlmac << " is not assigned to this node! table is full!" << endl;
+            IOTORII_EV(OPERATION) << "HLMAC address " << hlmac << " is not assigned to this node! table is full!" << endl;
         }
     }else{
-        EV << "Because of loop creation, HLMAC address " << hlmac << " is not assigned to this node." << endl;
+        IOTORII_EV(OPERATION) << "Because of loop creation, HLMAC address " << hlmac << " is not assigned to this node." << endl;
     }
 
-    statisticCollector->receiveSetHLMACMessage(arrivalTime);
-    EV << "<-IoToriiOperation::receiveSetHLMACMessage()" << endl;
+    emit(setHLMACReceivedSignal, arrivalTime);
+    IOTORII_EV(OPERATION) << "<-IoToriiOperation::receiveSetHLMACMessage()" << endl;
 }
 
 bool IoToriiOperation::hasLoop(HLMACAddress hlmac)
 {
-    EV << "->IoToriiOperation::hasLoop()" << endl;
+    IOTORII_EV(OPERATION) << "->IoToriiOperation::hasLoop()" << endl;
 
     HLMACAddress longestPrefix = hlmacTable->getlongestMatchedPrefix(hlmac);
     if (longestPrefix == HLMACAddress::UNSPECIFIED_ADDRESS){
-        EV << "HLMAC adress " << hlmac << " does not create a loop in this node. Longest Matched Prefix is UNSPECIFIED : " << longestPrefix << endl;
+        IOTORII_EV(OPERATION) << "HLMAC adress " << hlmac << " does not create a loop in this node. Longest Matched Prefix is UNSPECIFIED : " << longestPrefix << endl;
         return false;
     }
     else{
         numHLMACLoopable++;
-        EV << "HLMAC adress " << hlmac << " creates a loop in this node. Longest Matched Prefix is " << longestPrefix << endl;
+        IOTORII_EV(OPERATION) << "HLMAC adress " << hlmac << " creates a loop in this node. Longest Matched Prefix is " << longestPrefix << endl;
         return true;
     }
 
-    EV << "<-IoToriiOperation::hasLoop()" << endl;
+    IOTORII_EV(OPERATION) << "<-IoToriiOperation::hasLoop()" << endl;
 }
 
 bool IoToriiOperation::saveHLMAC(HLMACAddress hlmac)
 {
-    EV << "->IoToriiOperation::saveHLMAC()" << endl;
+    IOTORII_EV(OPERATION) << "->IoToriiOperation::saveHLMAC()" << endl;
 
     if ((maxHLMACs == -1) || ((maxHLMACs != -1) && (numHLMACAssigned < maxHLMACs))){
         hlmacTable->updateTableWithAddress(-1, hlmac);
         numHLMACAssigned++;
-        EV << "HLMAC adress " << hlmac << " was saved to this node, number of assigned HLMAC is " << numHLMACAssigned << "." << endl;
+        HLMACAddressDetails details(hlmac);
+        emit(hlmacAssignedSignal, simTime(), &details);
+        IOTORII_EV(OPERATION) << "HLMAC adress " << hlmac << " was saved to this node, number of assigned HLMAC is " << numHLMACAssigned << "." << endl;
         return true;
     }
     else{
-        EV << "HLMAC address is discarded! HLMAC table is full! Maximum number of allowed HLMAC is  " << maxHLMACs << "  number of assigned hlmac is " << numHLMACAssigned << ", so HLMAC table is full. " << endl;
+        IOTORII_EV(OPERATION) << "HLMAC address is discarded! HLMAC table is full! Maximum number of allowed HLMAC is  " << maxHLMACs << "  number of assigned hlmac is " << numHLMACAssigned << ", so HLMAC table is full. " << endl;
         return false;
     }
 
-    EV << "<-IoToriiOperation::saveHLMAC()" << endl;
+    IOTORII_EV(OPERATION) << "<-IoToriiOperation::saveHLMAC()" << endl;
 }
 
 void IoToriiOperation::handleMessage(cMessage *msg)
 {
-    EV << "->IoToriiOperation::handleMessage()" << endl;
+    IOTORII_EV(OPERATION) << "->IoToriiOperation::handleMessage()" << endl;
 
     if (!isOperational) {
-        EV << "Message '" << msg << "' arrived when module status is down, dropped it\n";
+        IOTORII_EV(OPERATION) << "Message '" << msg << "' arrived when module status is down, dropped it\n";
         delete msg;
         return;
     }
@@ -388,12 +625,12 @@ void IoToriiOperation::handleMessage(cMessage *msg)
     else
         throw cRuntimeError("Message '%s' received on unexpected gate '%s'", msg->getName(), msg->getArrivalGate()->getFullName());
 
-    EV << "<-IoToriiOperation::handleMessage()" << endl;
+    IOTORII_EV(OPERATION) << "<-IoToriiOperation::handleMessage()" << endl;
 }
 
 void IoToriiOperation::handleSelfMessage(cMessage *msg)
 {
-    EV << "<-IoToriiOperation::handleSelfMessage()" << endl;
+    IOTORII_EV(OPERATION) << "<-IoToriiOperation::handleSelfMessage()" << endl;
     if (msg == HelloTimer) {
         sendAndScheduleHello();
         return;
@@ -402,59 +639,97 @@ void IoToriiOperation::handleSelfMessage(cMessage *msg)
         startCore(corePrefix);
         return;
     }
+    else if (msg == trickleTransmitTimer) {
+        handleTrickleTransmitTimer();
+        return;
+    }
+    else if (msg == trickleIntervalTimer) {
+        if (isTrickleDone()){
+            IOTORII_EV(OPERATION) << "Trickle stops, every address was considered in " << trickleMaxIntervals << " intervals" << endl;
+            return;  //restarted by a new address or neighbor
+        }
+        trickleInterval = std::min(2 * trickleInterval, trickleImax);
+        startTrickleInterval();
+        return;
+    }
+    else if (msg == sendSetHLMACTimer) {
+        std::vector<HLMACAddress> prefixes;
+        prefixes.swap(pendingPrefixes);
+        sendSetHLMAC(prefixes, 0);  //the jitter delay is over
+        return;
+    }
+    else if (msg == reofferSetHLMACTimer) {
+        std::vector<HLMACAddress> prefixes;
+        for (auto & prefix : offeredPrefixes)
+            if (hlmacTable->isMyAddress(prefix))  //removed from the HLMAC table (aging, flush)
+                prefixes.push_back(prefix);
+        offeredPrefixes.swap(prefixes);
+        IOTORII_EV(OPERATION) << "New neighbors were learned from their Hellos, " << offeredPrefixes.size() << " prefixes are offered again" << endl;
+        if (!offeredPrefixes.empty())
+            sendSetHLMAC(offeredPrefixes, 0);  //the jitter delay is over
+        return;
+    }
     else
-        EV << "IoToriiOperation Error: unknown SelfMessage:" << msg << endl;
-    EV << "<-IoToriiOperation::handleSelfMessage()" << endl;
+        IOTORII_EV(OPERATION) << "IoToriiOperation Error: unknown SelfMessage:" << msg << endl;
+    IOTORII_EV(OPERATION) << "<-IoToriiOperation::handleSelfMessage()" << endl;
 }
 
 void IoToriiOperation::handleUpperPacket(cPacket *msg)
 {
-    EV << "->IoToriiOperation::handleUpperPacket()" << endl;
+    IOTORII_EV(OPERATION) << "->IoToriiOperation::handleUpperPacket()" << endl;
 
     throw cRuntimeError("->IoToriiOperation::handleUpperPacket(): The simulation doesn't process upper layer packets.");
 
-    EV << "<-IoToriiOperation::handleUpperPacket()" << endl;
+    IOTORII_EV(OPERATION) << "<-IoToriiOperation::handleUpperPacket()" << endl;
 }
 
 void IoToriiOperation::handleLowerPacket(cPacket *msg)
 {
-    EV << "->IoToriiOperation::handleLowerPacket()" << endl;
+    IOTORII_EV(OPERATION) << "->IoToriiOperation::handleLowerPacket()" << endl;
 
     numReceivedLowerPacket++;
 
-    if ((strcmp(msg->getName(),"Hello!")==0))
-    {
+    switch (msg->getKind()) {
+    case IOTORII_HELLO: {
         MACFrameBase *frame = check_and_cast<MACFrameBase *>(msg);
         numHelloRcvd++;
-        //to check duplicate hello
-        bool isDuplicate = false;
-        for(int i=0; i<numNeighbors; i++)
-            if (frame->getSrcAddr() == neighborList.at(i))
-                isDuplicate = true;
-
-        if (!isDuplicate){
-            neighborList.push_back(frame->getSrcAddr());
-            EV << "Hello message is received from : " << frame->getSrcAddr() << "; Number of neighbors is " << neighborList.size() <<endl;
-            numNeighbors++;
-            if (numNeighbors <= maxNeighbors)
-                numAllowedNeighbors++;
-            return;
-        }
-        else {
-            EV << "Hello message is received from : " << frame->getSrcAddr() << "is duplicate." <<endl;
-            return;
+        if (addNeighbor(frame->getSrcAddr())){  //duplicate Hellos are ignored
+            IOTORII_EV(OPERATION) << "Hello message is received from : " << frame->getSrcAddr() << "; Number of neighbors is " << neighborList.size() <<endl;
+            //passive neighbor discovery: the Hello replies to a SetHLMAC frame that did not target its sender, one frame offers the addresses again
+            if (reofferSetHLMACTimer && !offeredPrefixes.empty() && !reofferSetHLMACTimer->isScheduled()){
+                double delay = jitterPar->doubleValue();
+                IOTORII_EV(OPERATION) << "value of random jitter is " << delay << endl;
+                //more than maxJitter after the Hello, so the new neighbor trusts the short IDs of the frame (see extractMyAddresses())
+                scheduleAt(simTime() + maxJitter + delay, reofferSetHLMACTimer);
+            }
         }
+        else
+            IOTORII_EV(OPERATION) << "Hello message is received from : " << frame->getSrcAddr() << "is duplicate." <<endl;
+        delete frame;
+        return;
     } // END Hello
-    else if ((strcmp(msg->getName(),"SetHLMAC")==0)) {
+    case IOTORII_SETHLMAC: {
         numHLMACRcvd++;
         MACFrameBase *frame = check_and_cast<MACFrameBase *>(msg);
-        HLMACAddress hlmac = extractMyAddress(frame);
-        if (hlmac != HLMACAddress::UNSPECIFIED_ADDRESS){
-            receiveSetHLMACMessage(hlmac, frame->getArrivalTime());
-        }
+        simtime_t arrivalTime = frame->getArrivalTime();
+        if (passiveNeighborDiscovery && addNeighbor(frame->getSrcAddr()))
+            IOTORII_EV(OPERATION) << "Neighbor " << frame->getSrcAddr() << " is learned from its SetHLMAC frame; Number of neighbors is " << neighborList.size() << endl;
+        if (useTrickle)
+            countConsistentPrefixes(check_and_cast<const SetHLMACFrame *>(frame->getEncapsulatedPacket()));
+        std::vector<HLMACAddress> hlmacs;
+        extractMyAddresses(frame, hlmacs);    //deletes frame
+        for (auto & hlmac : hlmacs)
+            receiveSetHLMACMessage(hlmac, arrivalTime);
+        if (passiveNeighborDiscovery && hlmacs.empty())
+            scheduleHelloReply();
         return;
     } //END SetHLMAC
-    EV << "<-IoToriiOperation::handleLowerPacket()" << endl;
+    default:
+        IOTORII_EV(OPERATION) << "Frame " << msg->getName() << " of unknown kind " << msg->getKind() << " is dropped." << endl;
+        delete msg;
+        break;
+    }
+    IOTORII_EV(OPERATION) << "<-IoToriiOperation::handleLowerPacket()" << endl;
 }
 
 
@@ -483,6 +758,12 @@ void IoToriiOperation::sendDown(cMessage *message, double delay)
     sendDelayed(message, delay, lowerLayerOutGateId);
 }
 
+void IoToriiOperation::updateAnnounceTime(double delay)
+{
+    if ((announceTime < 0) || (simTime() + delay < announceTime))
+        announceTime = simTime() + delay;
+}
+
 void IoToriiOperation::getMessageStatistics(long &numHelloSent, long &numHLMACSent)
 {
     numHelloSent = this->numHelloSent;
@@ -507,24 +788,42 @@ bool IoToriiOperation::isLowerMessage(cMessage *message)
 
 void IoToriiOperation::start()
 {
-    EV << "->IoToriiOperation::start()" << endl;
+    IOTORII_EV(OPERATION) << "->IoToriiOperation::start()" << endl;
 
     hlmacTable->clearTable();
     neighborList.clear();
     isOperational = true;
 
-    EV << "<-IoToriiOperation::start()" << endl;
+    IOTORII_EV(OPERATION) << "<-IoToriiOperation::start()" << endl;
 }
 
 void IoToriiOperation::stop()
 {
-    EV << "->IoToriiOperation::stop()" << endl;
+    IOTORII_EV(OPERATION) << "->IoToriiOperation::stop()" << endl;
 
     hlmacTable->clearTable();
     neighborList.clear();
+    if (sendSetHLMACTimer)
+        cancelEvent(sendSetHLMACTimer);
+    pendingPrefixes.clear();
+    if (passiveNeighborDiscovery){
+        cancelEvent(HelloTimer);
+        lastHelloTime = -1;
+        if (reofferSetHLMACTimer)
+            cancelEvent(reofferSetHLMACTimer);
+        offeredPrefixes.clear();
+    }
+    isHeard = false;
+    announceTime = -1;
+    if (useTrickle){
+        cancelEvent(trickleTransmitTimer);
+        cancelEvent(trickleIntervalTimer);
+        trickleInterval = 0;
+        tricklePrefixes.clear();
+    }
     isOperational = false;
 
-    EV << "<-IoToriiOperation::stop()" << endl;
+    IOTORII_EV(OPERATION) << "<-IoToriiOperation::stop()" << endl;
 }
 
 bool IoToriiOperation::handleOperationStage(LifecycleOperation *operation, int stage, IDoneCallback *doneCallback)
@@ -555,17 +854,24 @@ bool IoToriiOperation::handleOperationStage(LifecycleOperation *operation, int s
 
 void IoToriiOperation::finish()
 {
-    EV << "->IoToriiOperation::finish()" << endl;
+    IOTORII_EV(OPERATION) << "->IoToriiOperation::finish()" << endl;
 
     recordScalar("hlmacLenIsLow", hlmacLenIsLow);
     recordScalar("hlmacWidthIsLow", hlmacWidthIsLow);
     recordScalar("Received Hello", numHelloRcvd);
     recordScalar("numHelloSent", numHelloSent);
+    if (passiveNeighborDiscovery)
+        recordScalar("numHelloSuppressed", numHelloSuppressed);
     recordScalar("numNeighbors", numNeighbors); //number of neighbors discovered by Hello message
     recordScalar("numHLMACRcvd", numHLMACRcvd);
     recordScalar("numHLMACAssigned", numHLMACAssigned);
     recordScalar("numHLMACLoopable", numHLMACLoopable);
+    recordScalar("numHLMACRefreshed", numHLMACRefreshed);
     recordScalar("numHLMACSent", numHLMACSent);
+    if (useTrickle)
+        recordScalar("numTrickleSuppressed", numTrickleSuppressed);
+    recordScalar("setHLMACPayloadBytes", setHLMACPayloadBytes);
+    recordScalar("setHLMACPayloadBytesWithMACs", setHLMACPayloadBytesWithMACs);
     recordScalar("numDiscardedNoHLMAC", numDiscardedNoHLMAC);
 
     recordScalar("Received Upper Packets", numReceivedUpperPacket);
@@ -576,6 +882,9 @@ void IoToriiOperation::finish()
     recordScalar("numDiscardedUnicastFrames", numDiscardedUnicastFrames);
     recordScalar("numDiscardedBroadcastFrames", numDiscardedBroadcastFrames);
 
+    if (checkHLMACCount && (numHLMACAssigned != (long)hlmacTable->getNumberOfAddresses()))
+        throw cRuntimeError("numHLMACAssigned is %ld, but the HLMAC table has %u addresses", numHLMACAssigned, hlmacTable->getNumberOfAddresses());
+
 
     if (startCoreEvent){
         cancelEvent(startCoreEvent);
@@ -589,7 +898,31 @@ void IoToriiOperation::finish()
         HelloTimer = nullptr;
     }
 
-    EV << "<-IoToriiOperation::finish()" << endl;
+    if (sendSetHLMACTimer){
+        cancelEvent(sendSetHLMACTimer);
+        delete sendSetHLMACTimer;
+        sendSetHLMACTimer = nullptr;
+    }
+
+    if (reofferSetHLMACTimer){
+        cancelEvent(reofferSetHLMACTimer);
+        delete reofferSetHLMACTimer;
+        reofferSetHLMACTimer = nullptr;
+    }
+
+    if (trickleTransmitTimer){
+        cancelEvent(trickleTransmitTimer);
+        delete trickleTransmitTimer;
+        trickleTransmitTimer = nullptr;
+    }
+
+    if (trickleIntervalTimer){
+        cancelEvent(trickleIntervalTimer);
+        delete trickleIntervalTimer;
+        trickleIntervalTimer = nullptr;
+    }
+
+    IOTORII_EV(OPERATION) << "<-IoToriiOperation::finish()" << endl;
 }
 
 IoToriiOperation::~IoToriiOperation()
@@ -605,6 +938,30 @@ IoToriiOperation::~IoToriiOperation()
         delete HelloTimer;
         HelloTimer = nullptr;
     }
+
+    if (sendSetHLMACTimer != nullptr){
+        cancelEvent(sendSetHLMACTimer);
+        delete sendSetHLMACTimer;
+        sendSetHLMACTimer = nullptr;
+    }
+
+    if (reofferSetHLMACTimer != nullptr){
+        cancelEvent(reofferSetHLMACTimer);
+        delete reofferSetHLMACTimer;
+        reofferSetHLMACTimer = nullptr;
+    }
+
+    if (trickleTransmitTimer != nullptr){
+        cancelEvent(trickleTransmitTimer);
+        delete trickleTransmitTimer;
+        trickleTransmitTimer = nullptr;
+    }
+
+    if (trickleIntervalTimer != nullptr){
+        cancelEvent(trickleIntervalTimer);
+        delete trickleIntervalTimer;
+        trickleIntervalTimer = nullptr;
+    }
 }
 
 } // namespace iotorii
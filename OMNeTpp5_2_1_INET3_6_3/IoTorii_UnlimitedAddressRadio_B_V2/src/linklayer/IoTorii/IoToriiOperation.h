@@ -30,15 +30,14 @@
 #include "inet/common/lifecycle/ILifecycle.h"
 //#include "src/linklayer/simpleidealmac/MACFrameIoTorii_m.h"
 #include "inet/linklayer/base/MACFrameBase_m.h"
-#include "src/linklayer/IoTorii/SetHLMCFrame_m.h"
+#include "src/linklayer/IoTorii/SetHLMACFrame.h"
+#include "src/linklayer/IoTorii/IoToriiSignals.h"
 
 
 
 namespace iotorii {
 using namespace inet;
 
-class StatisticCollector;
-
 class IoToriiOperation : public cSimpleModule, public ILifecycle
 {
 public:
@@ -51,7 +50,13 @@ public:
   //@}
 
   protected:
-    StatisticCollector *statisticCollector;
+    static simsignal_t coreStartedSignal;
+    static simsignal_t hlmacAssignedSignal;
+    static simsignal_t setHLMACReceivedSignal;
+    static simsignal_t helloSentSignal;
+    static simsignal_t setHLMACSentSignal;
+    static simsignal_t neighborAddedSignal;
+
     /** @brief Length of the header*/
     int headerLength;
     int headerLengthPANID;
@@ -71,17 +76,49 @@ public:
     int corePrefix;            // main core prefix, set by ned parameter
     simtime_t coreStartTime;
     simtime_t coreInterval;
+    simtime_t coreQuietPeriod;  //if > 0, startCoreEvent is moved to coreQuietPeriod after each new neighbor
+    simtime_t coreLatestStartTime;  //time of the first startCoreEvent, the upper bound of the adaptive start
 
     //Hello parameters
     simtime_t helloStartTime;
     simtime_t helloInterval; //"Hello" interval time, every helloInterval seconds a node broadcasts Hello messages
     cMessage *HelloTimer;
+    bool passiveNeighborDiscovery;  //neighbors are also learned from SetHLMAC frames, Hello only in reply to a SetHLMAC frame that does not target this node
+    int helloMaxRetries;  //passiveNeighborDiscovery: at most 1 + helloMaxRetries Hellos, helloInterval apart
+    simtime_t lastHelloTime;  //-1 if no Hello was sent
+    std::vector<HLMACAddress> offeredPrefixes;  //passiveNeighborDiscovery without Trickle: prefixes offered again to a neighbor learned from its Hello
+    cMessage *reofferSetHLMACTimer;
+    bool isHeard;  //this node has sent a SetHLMAC frame, so its neighbors have learned it
+    simtime_t announceTime;  //transmission time (after the jitter) of the first Hello or SetHLMAC frame of this node, -1 if none was sent
     /** HeT(Hello Table) **/
     std::vector<MACAddress> neighborList;
     unsigned int maxNeighbors; //maximum number of neighbors. changing this value needs to change HLMACAddress and eGA3Frame structure.
     int maxHLMACs; //maximum number of HLMAC table size.  -1 means "unlimited" size
+    unsigned int shortIdLength;  //bits of the neighbor short IDs in SetHLMAC frames, 0: MAC address and suffix per neighbor
+    bool aggregateSetHLMAC;  //prefixes accepted during the jitter delay share one SetHLMAC frame
+    std::vector<HLMACAddress> pendingPrefixes;  //prefixes waiting for sendSetHLMACTimer
+    cMessage *sendSetHLMACTimer;
+
+    //Trickle parameters and state (RFC 6206)
+    bool useTrickle;
+    simtime_t trickleImin;
+    simtime_t trickleImax;
+    int trickleK;
+    int trickleMaxIntervals;  //a prefix is considered in at most trickleMaxIntervals intervals, 0: no bound
+    simtime_t trickleInterval;  //I, zero until the first address is accepted
+    struct TricklePrefix
+    {
+        HLMACAddress prefix;  //an address of this node
+        int counter;  //c of this prefix, consistent SetHLMAC frames heard in the interval
+        int numIntervals;  //intervals in which the prefix was sent or suppressed, since it was accepted or a neighbor was added
+        bool isSent;  //sent since it was accepted or a neighbor was added, it is not suppressed before
+    };
+    std::vector<TricklePrefix> tricklePrefixes;
+    cMessage *trickleTransmitTimer;  //t
+    cMessage *trickleIntervalTimer;  //end of the interval
 
     IHLMACAddressTable *hlmacTable;
+    bool checkHLMACCount;  //finish() checks numHLMACAssigned against the HLMAC table
 
     cMessage *startCoreEvent;
 
@@ -92,12 +129,17 @@ public:
     //long hlmacAffectedByWidthIsLow;
     long numHelloRcvd;                 //Number of Hello messages received
     long numHelloSent;
+    long numHelloSuppressed;  //Hello retries not sent because the node had got an address meanwhile (passiveNeighborDiscovery)
     int numAllowedNeighbors;  //saves neighbors as long as width of HLMAC address (i.e. 3 for 3-bit width)
     long numNeighbors; //number of neighbors discovered by Hello message
     long numHLMACRcvd;
     long numHLMACAssigned;
     long numHLMACLoopable;  //or num discarded HLMAC
+    long numHLMACRefreshed;  //received addresses that were already in the HLMAC table (e.g. re-advertised by Trickle)
     long numHLMACSent;
+    long numTrickleSuppressed;  //Trickle transmissions suppressed by consistent SetHLMAC frames
+    long setHLMACPayloadBytes;  //bytes of the SetHLMAC payloads sent
+    long setHLMACPayloadBytesWithMACs;  //bytes the same payloads take with a MAC address and a suffix per neighbor
     long numDiscardedNoHLMAC; //if node has not HLMAC address, by dropping each packet, this variable is incremented.
 
     long numReceivedLowerPacket;
@@ -149,15 +191,40 @@ public:
     //Sends broadcast hello messages, src is MAC address and dst is broadcast MAC address
     virtual void sendAndScheduleHello();
 
+    //adds src to neighborList if it is new, returns true if it is new
+    virtual bool addNeighbor(const MACAddress& src);
+
+    //passiveNeighborDiscovery: schedules a Hello in reply to a SetHLMAC frame that does not target this node, if this node has no address and has retries left
+    virtual void scheduleHelloReply();
+
     //functionality of sink node
     virtual void startCore(int core);
 
-    //Sends broadcast SetHLMAC message to neighbors
+    //Sends broadcast SetHLMAC message to neighbors, or adds prefix to the pending SetHLMAC frame if aggregateSetHLMAC
     virtual void sendToNeighbors(HLMACAddress prefix);
 
-    HLMACAddress extractMyAddress(cPacket *frame);
+    //Creates one broadcast SetHLMAC frame with all prefixes and sends it after delay
+    virtual void sendSetHLMAC(const std::vector<HLMACAddress>& prefixes, double delay);
+
+    //Trickle: starts a new interval of length trickleInterval
+    virtual void startTrickleInterval();
+
+    //Trickle: an inconsistency (a new address of this node) resets the interval to trickleImin
+    virtual void resetTrickle();
 
-    //functionality of each node when it receives a SetHLMAC message
+    //Trickle: sends the addresses of this node that are not suppressed (sent before and trickleK consistent frames heard in the interval)
+    virtual void handleTrickleTransmitTimer();
+
+    //Trickle: true if every address of this node has been considered in trickleMaxIntervals intervals, the timer stops
+    virtual bool isTrickleDone();
+
+    //Trickle: a prefix of frame that extends an address of this node by one ID shows that a neighbor has got the offer of that address
+    virtual void countConsistentPrefixes(const SetHLMACFrame *frame);
+
+    //Appends the addresses of this node (each prefix followed by its suffix) to addresses, deletes frame
+    void extractMyAddresses(cPacket *frame, std::vector<HLMACAddress>& addresses);
+
+    //functionality of each node when it receives a SetHLMAC message, an address already in the table is only refreshed
     virtual void receiveSetHLMACMessage(HLMACAddress hlmac, simtime_t arrivalTime);
 
     //check whether received HLMAC address creates a loop or not.
@@ -172,6 +239,9 @@ public:
 
     virtual void sendDown(cMessage *message, double delay = 0);
 
+    //a Hello or SetHLMAC frame of this node is transmitted after delay, from then on its neighbors know its short ID
+    void updateAnnounceTime(double delay);
+
     virtual bool isUpperMessage(cMessage *message);
 
     virtual bool isLowerMessage(cMessage *message);
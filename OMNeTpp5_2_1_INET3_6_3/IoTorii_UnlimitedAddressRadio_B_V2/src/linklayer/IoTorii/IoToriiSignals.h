@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2018 Elisa Rojas(1), Hedayat Hosseini(2);
+ *                    (1) GIST, University of Alcala, Spain.
+ *                    (2) CEIT, Amirkabir University of Technology (Tehran Polytechnic), Iran.
+ *                    OMNeT++ 5.2.1 & INET 3.6.3
+*/
+
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef IOTORII_SRC_LINKLAYER_GA3SWITCH_IOTORIISIGNALS_H
+#define IOTORII_SRC_LINKLAYER_GA3SWITCH_IOTORIISIGNALS_H
+
+#include "inet/common/INETDefs.h"
+#include "src/linklayer/common/HLMACAddress.h"
+
+namespace iotorii {
+using namespace inet;
+
+/**
+ * Signals emitted by IoToriiOperation (see the NED definition), instead of calling StatisticCollector:
+ *   coreStarted       (simtime_t) the core starts, once
+ *   hlmacAssigned     (simtime_t, HLMACAddressDetails) a new address is saved in the HLMAC table
+ *   setHLMACReceived  (simtime_t) a SetHLMAC frame targeting this node is received
+ *   helloSent, setHLMACSent (long) a frame is sent
+ *   neighborAdded     (long) a new neighbor, 1 if it is allowed (numNeighbors <= maxNeighbors), 0 otherwise
+ * and by HLMACAddressTable:
+ *   hlmacRemoved      (simtime_t, HLMACAddressDetails) an entry is removed by aging, flush() or clearTable()
+ * The simtime_t value is the current simulation time, so the per-node result filters of the NED
+ * definition give the convergence metrics without StatisticCollector (e.g. with opp_scavetool).
+ * Signals do not cross the partitions of a parallel (PDES) run, and SimpleIdealRadioMedium still calls
+ * the radios directly, so the simulation cannot be partitioned yet.
+ */
+class HLMACAddressDetails : public cObject
+{
+  public:
+    HLMACAddress address;
+
+    HLMACAddressDetails(const HLMACAddress& address) : address(address) {}
+};
+
+} // namespace iotorii
+
+#endif // ifndef IOTORII_SRC_LINKLAYER_GA3SWITCH_IOTORIISIGNALS_H
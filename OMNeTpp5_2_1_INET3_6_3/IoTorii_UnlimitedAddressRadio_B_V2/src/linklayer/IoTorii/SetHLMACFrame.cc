@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2018 Elisa Rojas(1), Hedayat Hosseini(2);
+ *                    (1) GIST, University of Alcala, Spain.
+ *                    (2) CEIT, Amirkabir University of Technology (Tehran Polytechnic), Iran.
+ *                    OMNeT++ 5.2.1 & INET 3.6.3
+*/
+
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include "src/linklayer/IoTorii/SetHLMACFrame.h"
+
+#include <algorithm>
+
+namespace iotorii {
+
+Register_Class(SetHLMACFrame);
+
+#ifdef HLMAC_BENCHMARK
+unsigned long SetHLMACFrame::numCopies = 0;
+unsigned long SetHLMACFrame::numTargetOptionArrays = 0;
+#endif
+
+void SetHLMACFrame::detachTargetOptions()
+{
+    if (targetOptions && (targetOptions.use_count() > 1)){
+        targetOptions = std::make_shared<TargetOptions>(*targetOptions);
+        HLMAC_BENCHMARK_COUNT(numTargetOptionArrays);
+    }
+}
+
+void SetHLMACFrame::detachPrefixes()
+{
+    if (prefixes && (prefixes.use_count() > 1))
+        prefixes = std::make_shared<Prefixes>(*prefixes);
+}
+
+void SetHLMACFrame::parsimPack(omnetpp::cCommBuffer *b) const
+{
+    SetHLMACFrame_Base::parsimPack(b);
+    // as in the generated code of HLMACAddress and TargetOption arrays, there is no doParsimPacking() for them
+    if (getPrefixesArraySize() != 0)
+        throw omnetpp::cRuntimeError("Parsim error: No doParsimPacking() function for type HLMACAddress");
+    b->pack(0u);
+    if (getTargetOptionsArraySize() != 0)
+        throw omnetpp::cRuntimeError("Parsim error: No doParsimPacking() function for type TargetOption");
+    b->pack(0u);
+}
+
+void SetHLMACFrame::parsimUnpack(omnetpp::cCommBuffer *b)
+{
+    SetHLMACFrame_Base::parsimUnpack(b);
+    unsigned int size;
+    b->unpack(size);
+    if (size != 0)
+        throw omnetpp::cRuntimeError("Parsim error: No doParsimUnpacking() function for type HLMACAddress");
+    prefixes = nullptr;
+    b->unpack(size);
+    if (size != 0)
+        throw omnetpp::cRuntimeError("Parsim error: No doParsimUnpacking() function for type TargetOption");
+    targetOptions = nullptr;
+}
+
+void SetHLMACFrame::setPrefixesArraySize(unsigned int size)
+{
+    if (size == 0){
+        prefixes = nullptr;
+        return;
+    }
+    if (!prefixes)
+        prefixes = std::make_shared<Prefixes>();
+    else
+        detachPrefixes();
+    prefixes->resize(size);
+}
+
+HLMACAddress& SetHLMACFrame::getPrefixes(unsigned int k)
+{
+    if (k >= getPrefixesArraySize()) throw omnetpp::cRuntimeError("Array of size %d indexed by %d", getPrefixesArraySize(), k);
+    detachPrefixes();
+    return (*prefixes)[k];
+}
+
+const HLMACAddress& SetHLMACFrame::getPrefixes(unsigned int k) const
+{
+    if (k >= getPrefixesArraySize()) throw omnetpp::cRuntimeError("Array of size %d indexed by %d", getPrefixesArraySize(), k);
+    return (*prefixes)[k];
+}
+
+void SetHLMACFrame::setPrefixes(unsigned int k, const HLMACAddress& prefix)
+{
+    getPrefixes(k) = prefix;
+}
+
+void SetHLMACFrame::setTargetOptionsArraySize(unsigned int size)
+{
+    targetOptionsIndexed = false;
+    if (size == 0){
+        targetOptions = nullptr;
+        return;
+    }
+    if (!targetOptions){
+        targetOptions = std::make_shared<TargetOptions>();
+        HLMAC_BENCHMARK_COUNT(numTargetOptionArrays);
+    }
+    else
+        detachTargetOptions();
+    targetOptions->resize(size);
+}
+
+TargetOption& SetHLMACFrame::getTargetOptions(unsigned int k)
+{
+    if (k >= getTargetOptionsArraySize()) throw omnetpp::cRuntimeError("Array of size %d indexed by %d", getTargetOptionsArraySize(), k);
+    detachTargetOptions();
+    targetOptionsIndexed = false;    //the caller may change the MAC
+    return (*targetOptions)[k];
+}
+
+const TargetOption& SetHLMACFrame::getTargetOptions(unsigned int k) const
+{
+    if (k >= getTargetOptionsArraySize()) throw omnetpp::cRuntimeError("Array of size %d indexed by %d", getTargetOptionsArraySize(), k);
+    return (*targetOptions)[k];
+}
+
+void SetHLMACFrame::setTargetOptions(unsigned int k, const TargetOption& targetOption)
+{
+    getTargetOptions(k) = targetOption;
+}
+
+uint64_t SetHLMACFrame::getFilterBits(uint64_t key)
+{
+    // 3 bit positions from the top bits of a multiplicative hash (Fibonacci constant)
+    uint64_t hash = key * 0x9E3779B97F4A7C15ULL;
+    return (1ULL << (hash >> 58)) | (1ULL << ((hash >> 52) & 63)) | (1ULL << ((hash >> 46) & 63));
+}
+
+int64_t SetHLMACFrame::getPayloadBitLength(unsigned int shortIdLength) const
+{
+    int64_t length = 8 + 64 + 8;
+    for (unsigned int i = 0; i < getPrefixesArraySize(); i++)
+        length += 8 + (int64_t)getPrefixes(i).getHLMACLength() * HLMAC_WIDTH;
+    int64_t targetLength = shortIdLength ? shortIdLength : 48 + HLMAC_WIDTH;
+    return length + getTargetOptionsArraySize() * targetLength;
+}
+
+void SetHLMACFrame::indexTargetOptions(const std::vector<inet::MACAddress>& neighbors)
+{
+    uint64_t filter = 0;
+    if (targetOptions){
+        detachTargetOptions();
+        unsigned int shortIdLength = getShortIdLength();
+        auto isLess = [&shortIdLength](const TargetOption& a, const TargetOption& b) { return getTargetKey(a.MAC, shortIdLength) < getTargetKey(b.MAC, shortIdLength); };
+        std::sort(targetOptions->begin(), targetOptions->end(), isLess);
+        if (shortIdLength){
+            bool isUnique = true;
+            for (unsigned int i = 1; isUnique && (i < targetOptions->size()); i++)
+                isUnique = isLess((*targetOptions)[i - 1], (*targetOptions)[i]);
+            // the other neighbors receive the frame too, none of them may match the short ID of a target
+            for (unsigned int i = 0; isUnique && (i < neighbors.size()); i++){
+                uint64_t key = getTargetKey(neighbors[i], shortIdLength);
+                auto it = std::lower_bound(targetOptions->begin(), targetOptions->end(), key,
+                        [&shortIdLength](const TargetOption& option, uint64_t key) { return getTargetKey(option.MAC, shortIdLength) < key; });
+                isUnique = (it == targetOptions->end()) || (getTargetKey(it->MAC, shortIdLength) != key) || (it->MAC == neighbors[i]);
+            }
+            if (!isUnique){
+                // some receivers cannot be told apart by their short IDs, send the MAC addresses
+                shortIdLength = 0;
+                SetHLMACFrame_Base::setShortIdLength(0);
+                std::sort(targetOptions->begin(), targetOptions->end(), isLess);
+            }
+            for (unsigned int i = 0; shortIdLength && (i < targetOptions->size()); i++)
+                (*targetOptions)[i].suffix = i + 1;
+        }
+        for (const auto & option : *targetOptions)
+            filter |= getFilterBits(getTargetKey(option.MAC, shortIdLength));
+    }
+    setTargetFilter(filter);
+    targetOptionsIndexed = true;
+}
+
+int SetHLMACFrame::findTargetOption(const inet::MACAddress& mac) const
+{
+    if (!targetOptions)
+        return -1;
+    unsigned int shortIdLength = getShortIdLength();
+    uint64_t key = getTargetKey(mac, shortIdLength);
+    if (!targetOptionsIndexed){
+        for (unsigned int i = 0; i < targetOptions->size(); i++)
+            if (getTargetKey((*targetOptions)[i].MAC, shortIdLength) == key)
+                return i;
+        return -1;
+    }
+    uint64_t bits = getFilterBits(key);
+    if ((getTargetFilter() & bits) != bits)
+        return -1;
+    auto it = std::lower_bound(targetOptions->begin(), targetOptions->end(), key,
+            [&shortIdLength](const TargetOption& option, uint64_t key) { return getTargetKey(option.MAC, shortIdLength) < key; });
+    return ((it != targetOptions->end()) && (getTargetKey(it->MAC, shortIdLength) == key)) ? it - targetOptions->begin() : -1;
+}
+
+} // namespace iotorii
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2018 Elisa Rojas(1), Hedayat Hosseini(2);
+ *                    (1) GIST, University of Alcala, Spain.
+ *                    (2) CEIT, Amirkabir University of Technology (Tehran Polytechnic), Iran.
+ *                    OMNeT++ 5.2.1 & INET 3.6.3
+*/
+
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef IOTORII_SRC_LINKLAYER_GA3SWITCH_SETHLMACFRAME_H
+#define IOTORII_SRC_LINKLAYER_GA3SWITCH_SETHLMACFRAME_H
+
+#include "src/linklayer/IoTorii/SetHLMCFrame_m.h"
+
+#include <memory>
+#include <vector>
+
+namespace iotorii {
+
+/**
+ * SetHLMAC payload whose prefixes and targetOptions arrays are shared by its copies. The radio medium
+ * delivers one copy per receiver, and each receiver only reads the arrays, so a frame is
+ * allocated once and every copy costs a reference count instead of a deep copy.
+ * Any non-const access detaches the copy first (copy-on-write), so the frames keep value semantics.
+ *
+ * After indexTargetOptions(), the array is sorted by target key (the MAC address, or its short ID
+ * if shortIdLength is set) and targetFilter is a Bloom filter of the keys, so findTargetOption()
+ * rejects most non-targets in O(1) and finds a target by binary search.
+ *
+ * With short IDs, the suffix of a target is its position + 1 and is not sent. The array still
+ * keeps the MAC addresses and suffixes for the simulation, but only the short IDs are compared,
+ * and getPayloadBitLength() counts only what is sent.
+ */
+class SetHLMACFrame : public SetHLMACFrame_Base
+{
+  protected:
+    typedef std::vector<HLMACAddress> Prefixes;
+    typedef std::vector<TargetOption> TargetOptions;
+    std::shared_ptr<Prefixes> prefixes;    // nullptr if the array is empty
+    std::shared_ptr<TargetOptions> targetOptions;    // nullptr if the array is empty
+    bool targetOptionsIndexed = false;    // targetOptions is sorted by key and targetFilter is set
+
+#ifdef HLMAC_BENCHMARK
+  public:
+    //Benchmark of the frame copies (built with -DHLMAC_BENCHMARK), see StatisticCollector::finish()
+    static unsigned long numCopies;    // copies of SetHLMAC frames, each was a copy of targetOptions before
+    static unsigned long numTargetOptionArrays;    // targetOptions arrays allocated
+#endif
+
+  private:
+    void copy(const SetHLMACFrame& other) { prefixes = other.prefixes; targetOptions = other.targetOptions; targetOptionsIndexed = other.targetOptionsIndexed; HLMAC_BENCHMARK_COUNT(numCopies); }
+
+  protected:
+    /**
+     * @brief Makes targetOptions private to this frame before it is modified
+     */
+    void detachTargetOptions();
+
+    /**
+     * @brief Makes prefixes private to this frame before it is modified
+     */
+    void detachPrefixes();
+
+    /**
+     * @brief Bits of a target key in targetFilter (3 of the 64 bits)
+     */
+    static uint64_t getFilterBits(uint64_t key);
+
+  public:
+    SetHLMACFrame(const char *name=nullptr, short kind=0) : SetHLMACFrame_Base(name,kind) {}
+    SetHLMACFrame(const SetHLMACFrame& other) : SetHLMACFrame_Base(other) {copy(other);}
+    SetHLMACFrame& operator=(const SetHLMACFrame& other) {if (this==&other) return *this; SetHLMACFrame_Base::operator=(other); copy(other); return *this;}
+    virtual SetHLMACFrame *dup() const override {return new SetHLMACFrame(*this);}
+    virtual void parsimPack(omnetpp::cCommBuffer *b) const override;
+    virtual void parsimUnpack(omnetpp::cCommBuffer *b) override;
+
+    virtual void setPrefixesArraySize(unsigned int size) override;
+    virtual unsigned int getPrefixesArraySize() const override {return prefixes ? prefixes->size() : 0;}
+    virtual HLMACAddress& getPrefixes(unsigned int k) override;
+    virtual const HLMACAddress& getPrefixes(unsigned int k) const override;
+    virtual void setPrefixes(unsigned int k, const HLMACAddress& prefix) override;
+
+    virtual void setTargetOptionsArraySize(unsigned int size) override;
+    virtual unsigned int getTargetOptionsArraySize() const override {return targetOptions ? targetOptions->size() : 0;}
+    virtual TargetOption& getTargetOptions(unsigned int k) override;
+    virtual const TargetOption& getTargetOptions(unsigned int k) const override;
+    virtual void setTargetOptions(unsigned int k, const TargetOption& targetOption) override;
+    virtual void setShortIdLength(uint8_t shortIdLength) override {SetHLMACFrame_Base::setShortIdLength(shortIdLength); targetOptionsIndexed = false;}
+
+    /**
+     * @brief Key of a target: the short ID (low shortIdLength bits) of mac, or the whole mac if shortIdLength is 0
+     */
+    static uint64_t getTargetKey(const inet::MACAddress& mac, unsigned int shortIdLength) { return shortIdLength ? mac.getInt() & ((1ULL << shortIdLength) - 1) : mac.getInt(); }
+
+    /**
+     * @brief Bits sent for this payload with shortIdLength: number of prefixes (8) + per prefix, its length (8)
+     * and IDs + targetFilter (64) + shortIdLength (8) + per target, its short ID, or its MAC address (48)
+     * and suffix ID if shortIdLength is 0
+     */
+    int64_t getPayloadBitLength(unsigned int shortIdLength) const;
+
+    /**
+     * @brief Sorts targetOptions by key and sets targetFilter, call it when all target options are set.
+     * With short IDs, the suffixes are set to the positions + 1. If two targets have the same short ID,
+     * or a neighbor that is not a target has the short ID of a target (it would take the address of
+     * that target), shortIdLength is set to 0 and the suffixes are kept.
+     * neighbors are all known neighbors of the sender, the targets may be among them.
+     */
+    void indexTargetOptions(const std::vector<inet::MACAddress>& neighbors = std::vector<inet::MACAddress>());
+
+    /**
+     * @brief Returns the position of the target option of mac, or -1. Falls back to a linear scan if the frame is not indexed.
+     */
+    int findTargetOption(const inet::MACAddress& mac) const;
+
+    /**
+     * @brief Suffix of the target option at position k (implied by k with short IDs)
+     */
+    unsigned int getTargetSuffix(unsigned int k) const { return getShortIdLength() ? k + 1 : getTargetOptions(k).suffix; }
+};
+
+} // namespace iotorii
+
+#endif // ifndef IOTORII_SRC_LINKLAYER_GA3SWITCH_SETHLMACFRAME_H
@@ -178,27 +178,29 @@ inline std::ostream& operator<<(std::ostream& out, const std::vector<T,A>& vec)
     return out;
 }
 
-Register_Class(SetHLMACFrame)
+EXECUTE_ON_STARTUP(
+    omnetpp::cEnum *e = omnetpp::cEnum::find("iotorii::IoToriiFrameKind");
+    if (!e) omnetpp::enums.getInstance()->add(e = new omnetpp::cEnum("iotorii::IoToriiFrameKind"));
+    e->insert(IOTORII_HELLO, "IOTORII_HELLO");
+    e->insert(IOTORII_SETHLMAC, "IOTORII_SETHLMAC");
+)
 
-SetHLMACFrame::SetHLMACFrame(const char *name, short kind) : ::omnetpp::cPacket(name,kind)
+SetHLMACFrame_Base::SetHLMACFrame_Base(const char *name, short kind) : ::omnetpp::cPacket(name,kind)
 {
-    targetOptions_arraysize = 0;
-    this->targetOptions = 0;
+    this->targetFilter = 0;
+    this->shortIdLength = 0;
 }
 
-SetHLMACFrame::SetHLMACFrame(const SetHLMACFrame& other) : ::omnetpp::cPacket(other)
+SetHLMACFrame_Base::SetHLMACFrame_Base(const SetHLMACFrame_Base& other) : ::omnetpp::cPacket(other)
 {
-    targetOptions_arraysize = 0;
-    this->targetOptions = 0;
     copy(other);
 }
 
-SetHLMACFrame::~SetHLMACFrame()
+SetHLMACFrame_Base::~SetHLMACFrame_Base()
 {
-    delete [] this->targetOptions;
 }
 
-SetHLMACFrame& SetHLMACFrame::operator=(const SetHLMACFrame& other)
+SetHLMACFrame_Base& SetHLMACFrame_Base::operator=(const SetHLMACFrame_Base& other)
 {
     if (this==&other) return *this;
     ::omnetpp::cPacket::operator=(other);
@@ -206,74 +208,48 @@ SetHLMACFrame& SetHLMACFrame::operator=(const SetHLMACFrame& other)
     return *this;
 }
 
-void SetHLMACFrame::copy(const SetHLMACFrame& other)
+void SetHLMACFrame_Base::copy(const SetHLMACFrame_Base& other)
 {
-    this->prefix = other.prefix;
-    delete [] this->targetOptions;
-    this->targetOptions = (other.targetOptions_arraysize==0) ? nullptr : new TargetOption[other.targetOptions_arraysize];
-    targetOptions_arraysize = other.targetOptions_arraysize;
-    for (unsigned int i=0; i<targetOptions_arraysize; i++)
-        this->targetOptions[i] = other.targetOptions[i];
+    this->targetFilter = other.targetFilter;
+    this->shortIdLength = other.shortIdLength;
 }
 
-void SetHLMACFrame::parsimPack(omnetpp::cCommBuffer *b) const
+void SetHLMACFrame_Base::parsimPack(omnetpp::cCommBuffer *b) const
 {
     ::omnetpp::cPacket::parsimPack(b);
-    doParsimPacking(b,this->prefix);
-    b->pack(targetOptions_arraysize);
-    doParsimArrayPacking(b,this->targetOptions,targetOptions_arraysize);
+    // field prefixes is abstract -- please do packing in customized class
+    doParsimPacking(b,this->targetFilter);
+    doParsimPacking(b,this->shortIdLength);
+    // field targetOptions is abstract -- please do packing in customized class
 }
 
-void SetHLMACFrame::parsimUnpack(omnetpp::cCommBuffer *b)
+void SetHLMACFrame_Base::parsimUnpack(omnetpp::cCommBuffer *b)
 {
     ::omnetpp::cPacket::parsimUnpack(b);
-    doParsimUnpacking(b,this->prefix);
-    delete [] this->targetOptions;
-    b->unpack(targetOptions_arraysize);
-    if (targetOptions_arraysize==0) {
-        this->targetOptions = 0;
-    } else {
-        this->targetOptions = new TargetOption[targetOptions_arraysize];
-        doParsimArrayUnpacking(b,this->targetOptions,targetOptions_arraysize);
-    }
-}
-
-HLMACAddress& SetHLMACFrame::getPrefix()
-{
-    return this->prefix;
+    // field prefixes is abstract -- please do unpacking in customized class
+    doParsimUnpacking(b,this->targetFilter);
+    doParsimUnpacking(b,this->shortIdLength);
+    // field targetOptions is abstract -- please do unpacking in customized class
 }
 
-void SetHLMACFrame::setPrefix(const HLMACAddress& prefix)
+uint64_t SetHLMACFrame_Base::getTargetFilter() const
 {
-    this->prefix = prefix;
+    return this->targetFilter;
 }
 
-void SetHLMACFrame::setTargetOptionsArraySize(unsigned int size)
+void SetHLMACFrame_Base::setTargetFilter(uint64_t targetFilter)
 {
-    TargetOption *targetOptions2 = (size==0) ? nullptr : new TargetOption[size];
-    unsigned int sz = targetOptions_arraysize < size ? targetOptions_arraysize : size;
-    for (unsigned int i=0; i<sz; i++)
-        targetOptions2[i] = this->targetOptions[i];
-    targetOptions_arraysize = size;
-    delete [] this->targetOptions;
-    this->targetOptions = targetOptions2;
+    this->targetFilter = targetFilter;
 }
 
-unsigned int SetHLMACFrame::getTargetOptionsArraySize() const
+uint8_t SetHLMACFrame_Base::getShortIdLength() const
 {
-    return targetOptions_arraysize;
+    return this->shortIdLength;
 }
 
-TargetOption& SetHLMACFrame::getTargetOptions(unsigned int k)
+void SetHLMACFrame_Base::setShortIdLength(uint8_t shortIdLength)
 {
-    if (k>=targetOptions_arraysize) throw omnetpp::cRuntimeError("Array of size %d indexed by %d", targetOptions_arraysize, k);
-    return this->targetOptions[k];
-}
-
-void SetHLMACFrame::setTargetOptions(unsigned int k, const TargetOption& targetOptions)
-{
-    if (k>=targetOptions_arraysize) throw omnetpp::cRuntimeError("Array of size %d indexed by %d", targetOptions_arraysize, k);
-    this->targetOptions[k] = targetOptions;
+    this->shortIdLength = shortIdLength;
 }
 
 class SetHLMACFrameDescriptor : public omnetpp::cClassDescriptor
@@ -318,7 +294,7 @@ SetHLMACFrameDescriptor::~SetHLMACFrameDescriptor()
 
 bool SetHLMACFrameDescriptor::doesSupport(omnetpp::cObject *obj) const
 {
-    return dynamic_cast<SetHLMACFrame *>(obj)!=nullptr;
+    return dynamic_cast<SetHLMACFrame_Base *>(obj)!=nullptr;
 }
 
 const char **SetHLMACFrameDescriptor::getPropertyNames() const
@@ -341,7 +317,7 @@ const char *SetHLMACFrameDescriptor::getProperty(const char *propertyname) const
 int SetHLMACFrameDescriptor::getFieldCount() const
 {
     omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
-    return basedesc ? 2+basedesc->getFieldCount() : 2;
+    return basedesc ? 4+basedesc->getFieldCount() : 4;
 }
 
 unsigned int SetHLMACFrameDescriptor::getFieldTypeFlags(int field) const
@@ -353,10 +329,12 @@ unsigned int SetHLMACFrameDescriptor::getFieldTypeFlags(int field) const
         field -= basedesc->getFieldCount();
     }
     static unsigned int fieldTypeFlags[] = {
-        FD_ISCOMPOUND,
+        FD_ISARRAY | FD_ISCOMPOUND,
+        FD_ISEDITABLE,
+        FD_ISEDITABLE,
         FD_ISARRAY | FD_ISCOMPOUND,
     };
-    return (field>=0 && field<2) ? fieldTypeFlags[field] : 0;
+    return (field>=0 && field<4) ? fieldTypeFlags[field] : 0;
 }
 
 const char *SetHLMACFrameDescriptor::getFieldName(int field) const
@@ -368,18 +346,22 @@ const char *SetHLMACFrameDescriptor::getFieldName(int field) const
         field -= basedesc->getFieldCount();
     }
     static const char *fieldNames[] = {
-        "prefix",
+        "prefixes",
+        "targetFilter",
+        "shortIdLength",
         "targetOptions",
     };
-    return (field>=0 && field<2) ? fieldNames[field] : nullptr;
+    return (field>=0 && field<4) ? fieldNames[field] : nullptr;
 }
 
 int SetHLMACFrameDescriptor::findField(const char *fieldName) const
 {
     omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
     int base = basedesc ? basedesc->getFieldCount() : 0;
-    if (fieldName[0]=='p' && strcmp(fieldName, "prefix")==0) return base+0;
-    if (fieldName[0]=='t' && strcmp(fieldName, "targetOptions")==0) return base+1;
+    if (fieldName[0]=='p' && strcmp(fieldName, "prefixes")==0) return base+0;
+    if (fieldName[0]=='t' && strcmp(fieldName, "targetFilter")==0) return base+1;
+    if (fieldName[0]=='s' && strcmp(fieldName, "shortIdLength")==0) return base+2;
+    if (fieldName[0]=='t' && strcmp(fieldName, "targetOptions")==0) return base+3;
     return basedesc ? basedesc->findField(fieldName) : -1;
 }
 
@@ -393,9 +375,11 @@ const char *SetHLMACFrameDescriptor::getFieldTypeString(int field) const
     }
     static const char *fieldTypeStrings[] = {
         "HLMACAddress",
+        "uint64_t",
+        "uint8_t",
         "TargetOption",
     };
-    return (field>=0 && field<2) ? fieldTypeStrings[field] : nullptr;
+    return (field>=0 && field<4) ? fieldTypeStrings[field] : nullptr;
 }
 
 const char **SetHLMACFrameDescriptor::getFieldPropertyNames(int field) const
@@ -432,9 +416,10 @@ int SetHLMACFrameDescriptor::getFieldArraySize(void *object, int field) const
             return basedesc->getFieldArraySize(object, field);
         field -= basedesc->getFieldCount();
     }
-    SetHLMACFrame *pp = (SetHLMACFrame *)object; (void)pp;
+    SetHLMACFrame_Base *pp = (SetHLMACFrame_Base *)object; (void)pp;
     switch (field) {
-        case 1: return pp->getTargetOptionsArraySize();
+        case 0: return pp->getPrefixesArraySize();
+        case 3: return pp->getTargetOptionsArraySize();
         default: return 0;
     }
 }
@@ -447,7 +432,7 @@ const char *SetHLMACFrameDescriptor::getFieldDynamicTypeString(void *object, int
             return basedesc->getFieldDynamicTypeString(object,field,i);
         field -= basedesc->getFieldCount();
     }
-    SetHLMACFrame *pp = (SetHLMACFrame *)object; (void)pp;
+    SetHLMACFrame_Base *pp = (SetHLMACFrame_Base *)object; (void)pp;
     switch (field) {
         default: return nullptr;
     }
@@ -461,10 +446,12 @@ std::string SetHLMACFrameDescriptor::getFieldValueAsString(void *object, int fie
             return basedesc->getFieldValueAsString(object,field,i);
         field -= basedesc->getFieldCount();
     }
-    SetHLMACFrame *pp = (SetHLMACFrame *)object; (void)pp;
+    SetHLMACFrame_Base *pp = (SetHLMACFrame_Base *)object; (void)pp;
     switch (field) {
-        case 0: {std::stringstream out; out << pp->getPrefix(); return out.str();}
-        case 1: {std::stringstream out; out << pp->getTargetOptions(i); return out.str();}
+        case 0: {std::stringstream out; out << pp->getPrefixes(i); return out.str();}
+        case 1: return uint642string(pp->getTargetFilter());
+        case 2: return ulong2string(pp->getShortIdLength());
+        case 3: {std::stringstream out; out << pp->getTargetOptions(i); return out.str();}
         default: return "";
     }
 }
@@ -477,8 +464,10 @@ bool SetHLMACFrameDescriptor::setFieldValueAsString(void *object, int field, int
             return basedesc->setFieldValueAsString(object,field,i,value);
         field -= basedesc->getFieldCount();
     }
-    SetHLMACFrame *pp = (SetHLMACFrame *)object; (void)pp;
+    SetHLMACFrame_Base *pp = (SetHLMACFrame_Base *)object; (void)pp;
     switch (field) {
+        case 1: pp->setTargetFilter(string2uint64(value)); return true;
+        case 2: pp->setShortIdLength(string2ulong(value)); return true;
         default: return false;
     }
 }
@@ -493,7 +482,7 @@ const char *SetHLMACFrameDescriptor::getFieldStructName(int field) const
     }
     switch (field) {
         case 0: return omnetpp::opp_typename(typeid(HLMACAddress));
-        case 1: return omnetpp::opp_typename(typeid(TargetOption));
+        case 3: return omnetpp::opp_typename(typeid(TargetOption));
         default: return nullptr;
     };
 }
@@ -506,10 +495,10 @@ void *SetHLMACFrameDescriptor::getFieldStructValuePointer(void *object, int fiel
             return basedesc->getFieldStructValuePointer(object, field, i);
         field -= basedesc->getFieldCount();
     }
-    SetHLMACFrame *pp = (SetHLMACFrame *)object; (void)pp;
+    SetHLMACFrame_Base *pp = (SetHLMACFrame_Base *)object; (void)pp;
     switch (field) {
-        case 0: return (void *)(&pp->getPrefix()); break;
-        case 1: return (void *)(&pp->getTargetOptions(i)); break;
+        case 0: return (void *)(&pp->getPrefixes(i)); break;
+        case 3: return (void *)(&pp->getTargetOptions(i)); break;
         default: return nullptr;
     }
 }
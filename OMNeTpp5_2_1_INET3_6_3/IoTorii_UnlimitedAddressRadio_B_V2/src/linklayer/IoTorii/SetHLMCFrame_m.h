@@ -32,52 +32,114 @@
 namespace iotorii {
 
 /**
- * Class generated from <tt>src/linklayer/IoTorii/SetHLMCFrame.msg:41</tt> by nedtool.
+ * Enum generated from <tt>src/linklayer/IoTorii/SetHLMCFrame.msg:44</tt> by nedtool.
  * <pre>
+ * //
+ * // Kinds (cMessage::getKind()) of the IoTorii frames, the layers dispatch on them
+ * // instead of comparing the frame names.
+ * //
+ * enum IoToriiFrameKind
+ * {
+ *     IOTORII_HELLO = 1;
+ *     IOTORII_SETHLMAC = 2;
+ * }
+ * </pre>
+ */
+enum IoToriiFrameKind {
+    IOTORII_HELLO = 1,
+    IOTORII_SETHLMAC = 2
+};
+
+/**
+ * Class generated from <tt>src/linklayer/IoTorii/SetHLMCFrame.msg:60</tt> by nedtool.
+ * <pre>
+ * //
+ * // A SetHLMAC frame advertises one or more prefixes (e.g. the addresses a node accepted during
+ * // one jitter delay), each target gets every prefix followed by its suffix.
+ * // prefixes and targetOptions are implemented in SetHLMACFrame.h: the copies of a frame (one per
+ * // receiver) share the arrays until one of them modifies them. indexTargetOptions() sorts the array by MAC
+ * // address and sets targetFilter, a Bloom filter of the target MAC addresses, so a receiver
+ * // finds its target option (or that it is not a target) without scanning the array.
+ * // If shortIdLength is not 0, each target is sent as the short ID of its MAC address (its low
+ * // shortIdLength bits) and its suffix is its position + 1, see SetHLMACFrame::getPayloadBitLength().
+ * //
  * packet SetHLMACFrame
  * {
- *     HLMACAddress prefix;
- *     TargetOption targetOptions[];
+ *     \@customize(true);
+ *     abstract HLMACAddress prefixes[];
+ *     uint64_t targetFilter;
+ *     uint8_t shortIdLength;  //0: MAC address and suffix of each target
+ *     abstract TargetOption targetOptions[];
  * }
  * </pre>
+ *
+ * SetHLMACFrame_Base is only useful if it gets subclassed, and SetHLMACFrame is derived from it.
+ * The minimum code to be written for SetHLMACFrame is the following:
+ *
+ * <pre>
+ * class SetHLMACFrame : public SetHLMACFrame_Base
+ * {
+ *   private:
+ *     void copy(const SetHLMACFrame& other) { ... }
+
+ *   public:
+ *     SetHLMACFrame(const char *name=nullptr, short kind=0) : SetHLMACFrame_Base(name,kind) {}
+ *     SetHLMACFrame(const SetHLMACFrame& other) : SetHLMACFrame_Base(other) {copy(other);}
+ *     SetHLMACFrame& operator=(const SetHLMACFrame& other) {if (this==&other) return *this; SetHLMACFrame_Base::operator=(other); copy(other); return *this;}
+ *     virtual SetHLMACFrame *dup() const override {return new SetHLMACFrame(*this);}
+ *     // ADD CODE HERE to redefine and implement pure virtual functions from SetHLMACFrame_Base
+ * };
+ * </pre>
+ *
+ * The following should go into a .cc (.cpp) file:
+ *
+ * <pre>
+ * Register_Class(SetHLMACFrame)
+ * </pre>
  */
-class SetHLMACFrame : public ::omnetpp::cPacket
+class SetHLMACFrame_Base : public ::omnetpp::cPacket
 {
   protected:
-    HLMACAddress prefix;
-    TargetOption *targetOptions; // array ptr
-    unsigned int targetOptions_arraysize;
+    // field prefixes is abstract
+    uint64_t targetFilter;
+    uint8_t shortIdLength;
+    // field targetOptions is abstract
 
   private:
-    void copy(const SetHLMACFrame& other);
+    void copy(const SetHLMACFrame_Base& other);
 
   protected:
     // protected and unimplemented operator==(), to prevent accidental usage
-    bool operator==(const SetHLMACFrame&);
+    bool operator==(const SetHLMACFrame_Base&);
+    // make constructors protected to avoid instantiation
+    SetHLMACFrame_Base(const char *name=nullptr, short kind=0);
+    SetHLMACFrame_Base(const SetHLMACFrame_Base& other);
+    // make assignment operator protected to force the user override it
+    SetHLMACFrame_Base& operator=(const SetHLMACFrame_Base& other);
 
   public:
-    SetHLMACFrame(const char *name=nullptr, short kind=0);
-    SetHLMACFrame(const SetHLMACFrame& other);
-    virtual ~SetHLMACFrame();
-    SetHLMACFrame& operator=(const SetHLMACFrame& other);
-    virtual SetHLMACFrame *dup() const override {return new SetHLMACFrame(*this);}
+    virtual ~SetHLMACFrame_Base();
+    virtual SetHLMACFrame_Base *dup() const override {throw omnetpp::cRuntimeError("You forgot to manually add a dup() function to class SetHLMACFrame");}
     virtual void parsimPack(omnetpp::cCommBuffer *b) const override;
     virtual void parsimUnpack(omnetpp::cCommBuffer *b) override;
 
     // field getter/setter methods
-    virtual HLMACAddress& getPrefix();
-    virtual const HLMACAddress& getPrefix() const {return const_cast<SetHLMACFrame*>(this)->getPrefix();}
-    virtual void setPrefix(const HLMACAddress& prefix);
-    virtual void setTargetOptionsArraySize(unsigned int size);
-    virtual unsigned int getTargetOptionsArraySize() const;
-    virtual TargetOption& getTargetOptions(unsigned int k);
-    virtual const TargetOption& getTargetOptions(unsigned int k) const {return const_cast<SetHLMACFrame*>(this)->getTargetOptions(k);}
-    virtual void setTargetOptions(unsigned int k, const TargetOption& targetOptions);
+    virtual void setPrefixesArraySize(unsigned int size) = 0;
+    virtual unsigned int getPrefixesArraySize() const = 0;
+    virtual HLMACAddress& getPrefixes(unsigned int k) = 0;
+    virtual const HLMACAddress& getPrefixes(unsigned int k) const {return const_cast<SetHLMACFrame_Base*>(this)->getPrefixes(k);}
+    virtual void setPrefixes(unsigned int k, const HLMACAddress& prefixes) = 0;
+    virtual uint64_t getTargetFilter() const;
+    virtual void setTargetFilter(uint64_t targetFilter);
+    virtual uint8_t getShortIdLength() const;
+    virtual void setShortIdLength(uint8_t shortIdLength);
+    virtual void setTargetOptionsArraySize(unsigned int size) = 0;
+    virtual unsigned int getTargetOptionsArraySize() const = 0;
+    virtual TargetOption& getTargetOptions(unsigned int k) = 0;
+    virtual const TargetOption& getTargetOptions(unsigned int k) const {return const_cast<SetHLMACFrame_Base*>(this)->getTargetOptions(k);}
+    virtual void setTargetOptions(unsigned int k, const TargetOption& targetOptions) = 0;
 };
 
-inline void doParsimPacking(omnetpp::cCommBuffer *b, const SetHLMACFrame& obj) {obj.parsimPack(b);}
-inline void doParsimUnpacking(omnetpp::cCommBuffer *b, SetHLMACFrame& obj) {obj.parsimUnpack(b);}
-
 } // namespace iotorii
 
 #endif // ifndef __IOTORII_SETHLMCFRAME_M_H
@@ -23,55 +23,220 @@
 #include "src/linklayer/common/HLMACAddress.h"
 
 #include <ctype.h>
+#include <vector>
 
 namespace iotorii {
 
+#ifdef HLMAC_BENCHMARK
+unsigned long HLMACAddress::numHeapAllocations = 0;
+unsigned long HLMACAddress::numCopies = 0;
+#endif
+
 unsigned int unspecifiedArray[8] = {0,0,0,0,0,0,0,0};
-const HLMACAddress HLMACAddress::UNSPECIFIED_ADDRESS(unspecifiedArray);
+const HLMACAddress HLMACAddress::UNSPECIFIED_ADDRESS(unspecifiedArray, 8);
 unsigned int broadcastArray[8] = {255,255,255,255,255,255,255,255};
-const HLMACAddress HLMACAddress::BROADCAST_ADDRESS(broadcastArray);
+const HLMACAddress HLMACAddress::BROADCAST_ADDRESS(broadcastArray, 8);
+
+
+#ifdef HLMAC_INTERNED
+HLMACPrefixNode *HLMACAddress::getRoot()
+{
+    static HLMACPrefixNode *root = nullptr;
+    if (root == nullptr) {
+        root = new HLMACPrefixNode(nullptr, 0);
+        root->refCount = 1;  //never released
+    }
+    return root;
+}
+
+HLMACPrefixNode *HLMACAddress::getChild(HLMACPrefixNode *parent, unsigned int id)
+{
+    HLMACPrefixNode *& child = parent->children[id];
+    if (child == nullptr) {
+        child = new HLMACPrefixNode(parent, id);
+        HLMAC_BENCHMARK_COUNT(numHeapAllocations);
+        retain(parent);
+    }
+    retain(child);
+    return child;
+}
+
+/*
+ * Drops one reference, and deletes the nodes that are no longer used by any address.
+ */
+void HLMACAddress::release(HLMACPrefixNode *node)
+{
+    while ((node != nullptr) && (--node->refCount == 0)) {
+        HLMACPrefixNode *parent = node->parent;
+        parent->children.erase(node->id);
+        delete node;
+        node = parent;
+    }
+}
+
+HLMACAddress::HLMACAddress(const unsigned int array[], unsigned int arrayLength) :
+    node(getRoot())
+{
+    retain(node);
+    for (unsigned int i = 0; i < arrayLength; i++)
+        addNewId(array[i]);
+}
 
+void HLMACAddress::setIndexValue(unsigned int k, unsigned int addrbyte)
+{
+    if (k >= node->depth)
+        throw cRuntimeError("HLMACAddress::setIndexValue(): index %u is not in range", k);
+    if (getIndexValue(k) == addrbyte)
+        return;
+    //the IDs after k are kept, and the address is rebuilt below the new kth node
+    std::vector<unsigned int> suffix(node->depth - k - 1);
+    for (HLMACPrefixNode *n = node; n->depth > k + 1; n = n->parent)
+        suffix[n->depth - k - 2] = n->id;
+    HLMACPrefixNode *newNode = getChild(getAncestor(node, k), addrbyte);
+    for (auto id : suffix) {
+        HLMACPrefixNode *child = getChild(newNode, id);
+        release(newNode);
+        newNode = child;
+    }
+    release(node);
+    node = newNode;
+}
 
 std::string HLMACAddress::str() const
 {
-    char *buf = new char[address.size() * (4 +1) + 1];  //first 1 for dot, second 1 for "\0"
-    char *s = buf;
-    int i;
-    for (i = 0; i < address.size(); i++, s += 5)
-        sprintf(s, "%4.4u.", getIndexValue(i));
-    *(s) = '\0';
-    return std::string(buf);
+    std::string buf(node->depth * (4 + 1), ' ');  //1 for dot
+    char s[16];
+    for (HLMACPrefixNode *n = node; n->depth > 0; n = n->parent) {
+        sprintf(s, "%4.4u.", n->id);
+        buf.replace((n->depth - 1) * (4 + 1), 4 + 1, s);
+    }
+    return buf;
 }
 
 int HLMACAddress::compareTo(const HLMACAddress& other) const
 {
-    int minSize = (address.size() < other.address.size()) ? address.size() : other.address.size();
+    if (node == other.node)
+        return 0;
+    //the deeper address is compared to the ancestor of the same depth, its extra IDs count only if they are not zero
+    const HLMACPrefixNode *a = node, *b = other.node;
+    int extraIds = 0;
+    for (; a->depth > b->depth; a = a->parent)
+        if (a->id > 0)
+            extraIds = +1;
+    for (; b->depth > a->depth; b = b->parent)
+        if (b->id > 0)
+            extraIds = -1;
+    if (a == b)
+        return extraIds;
+    while (a->parent != b->parent) {
+        a = a->parent;
+        b = b->parent;
+    }
+    return (a->id > b->id) ? +1 : -1;
+}
 
-    for (int i=0; i<minSize; i++){
-        if (address.at(i) > other.address.at(i))
+//Used for hopCount metric
+unsigned int HLMACAddress::getLongestCommonPrefixLength(const HLMACAddress &other) const
+{
+    //the common prefix is the deepest common ancestor
+    const HLMACPrefixNode *a = getAncestor(node, other.node->depth), *b = getAncestor(other.node, node->depth);
+    while (a != b) {
+        a = a->parent;
+        b = b->parent;
+    }
+    return a->depth;
+}
+
+#else
+HLMACAddress::HLMACAddress(const unsigned int array[], unsigned int arrayLength) :
+    length(0),
+    capacity(HLMAC_INLINE_LENGTH),
+    ids(inlineIds)
+{
+    reserve(arrayLength);
+    for (unsigned int i = 0; i < arrayLength; i++)
+        ids[i] = array[i];
+    length = arrayLength;
+}
+
+/*
+ * Grows the storage to at least newCapacity IDs. Addresses up to HLMAC_INLINE_LENGTH IDs
+ * never get here, so only very deep trees pay for a heap block.
+ */
+void HLMACAddress::reserve(unsigned int newCapacity)
+{
+    if (newCapacity <= capacity)
+        return;
+    unsigned int *newIds = new unsigned int[newCapacity];
+    HLMAC_BENCHMARK_COUNT(numHeapAllocations);
+    for (unsigned int i = 0; i < length; i++)
+        newIds[i] = ids[i];
+    if (ids != inlineIds)
+        delete[] ids;
+    ids = newIds;
+    capacity = newCapacity;
+}
+
+void HLMACAddress::copyFrom(const HLMACAddress& other)
+{
+    HLMAC_BENCHMARK_COUNT(numCopies);
+    if ((other.length <= HLMAC_INLINE_LENGTH) && (ids != inlineIds))
+        releaseStorage();  //don't keep a heap block for a short address
+    reserve(other.length);
+    for (unsigned int i = 0; i < other.length; i++)
+        ids[i] = other.ids[i];
+    length = other.length;
+}
+
+std::string HLMACAddress::str() const
+{
+    std::string buf;
+    buf.reserve(length * (4 + 1));  //1 for dot
+    char s[16];
+    for (unsigned int i = 0; i < length; i++) {
+        sprintf(s, "%4.4u.", ids[i]);
+        buf += s;
+    }
+    return buf;
+}
+
+int HLMACAddress::compareTo(const HLMACAddress& other) const
+{
+    unsigned int minSize = (length < other.length) ? length : other.length;
+
+    for (unsigned int i=0; i<minSize; i++){
+        if (ids[i] > other.ids[i])
             return +1;
-        else if (address.at(i) < other.address.at(i))
+        else if (ids[i] < other.ids[i])
             return -1;
     }
-    if (address.size() == other.address.size())
-        return 0;
-    else if (address.size() > other.address.size()){
-        for (int i=minSize; i< address.size(); i++){
-            if (address.at(i) > 0)
+    if (length > other.length){
+        for (unsigned int i=minSize; i< length; i++){
+            if (ids[i] > 0)
                 return +1;
         }
-        return 0;
     }
-    else if (address.size() < other.address.size()){
-        for (int i=minSize; i< other.address.size(); i++){
-            if (other.address.at(i) > 0)
+    else if (length < other.length){
+        for (unsigned int i=minSize; i< other.length; i++){
+            if (other.ids[i] > 0)
                 return -1;
         }
-        return 0;
     }
+    return 0;
+}
 
+//Used for hopCount metric
+unsigned int HLMACAddress::getLongestCommonPrefixLength(const HLMACAddress &other) const
+{
+    unsigned int minLen = (length < other.length) ? length : other.length;
+    unsigned int i = 0;
+    while ((i < minLen) && (ids[i] == other.ids[i]))
+        i++;
+    return i;
 }
 
+#endif
+
 /*
 unsigned short int HLMACAddress::getHLMACHier()
 {
@@ -85,24 +250,16 @@ HLMACAddress HLMACAddress::getLongestCommonPrefix(const HLMACAddress &other)
 {
     //EV << "-->HLMACAddress::getLongestCommonPrefix()" << endl;
 
-  unsigned int minLen = (getHLMACLength() < other.getHLMACLength()) ? getHLMACLength() : other.getHLMACLength();
-  unsigned int i = 0;
-  //EV << "minLen = " << minLen << " getHLMACLength = " << getHLMACLength() << ", other.getHLMACLength() = " << other.getHLMACLength() << endl;
+  unsigned int i = getLongestCommonPrefixLength(other);
 
   /*
    *  We dont use "HLMACAddress commonPrexif = HLMACAddress::UNSPECIFIED_ADDRESS;"
    *  because HLMACLength is 8 for HLMACAddress::UNSPECIFIED_ADDRESS!
    */
-  HLMACAddress commonPrexif;
-
-  while((i < minLen) && (getIndexValue(i) == other.getIndexValue(i)))
-  {
-      if (i == 0)
-          commonPrexif.setIndexValue(i, getIndexValue(i));
-      else
-          commonPrexif.addNewId(getIndexValue(i));
-      i++;
-  }
+  HLMACAddress commonPrexif(*this);
+  while (commonPrexif.getHLMACLength() > i)
+      commonPrexif.removeLastId();
+
   //EV << " commonPrexif = " << commonPrexif << endl;
   if (i > 0){
       //EV << "-->HLMACAddress::getLongestCommonPrefix(1)" << endl;
@@ -114,13 +271,16 @@ HLMACAddress HLMACAddress::getLongestCommonPrefix(const HLMACAddress &other)
 }
 
 //Used for hopCount metric
-int HLMACAddress::numHopsBetweenAddresses(const HLMACAddress &other)
+int HLMACAddress::numHopsBetweenAddresses(const HLMACAddress &other) const
 {
     //EV << "-->HLMACAddress::numHopsBetweenAddresses()" << endl;
 
-    HLMACAddress ancestor = getLongestCommonPrefix(other);
-    unsigned int ancestorLen = ancestor.getHLMACLength();
-    if ((ancestorLen == 0) || (ancestor == HLMACAddress::UNSPECIFIED_ADDRESS))
+    unsigned int ancestorLen = getLongestCommonPrefixLength(other);
+    // an all-zero ancestor is equal to HLMACAddress::UNSPECIFIED_ADDRESS
+    unsigned int numZeroIds = 0;
+    while ((numZeroIds < ancestorLen) && (getIndexValue(numZeroIds) == 0))
+        numZeroIds++;
+    if ((ancestorLen == 0) || (numZeroIds == ancestorLen))
         //return -1;
         throw cRuntimeError("HLMACAddress::numHopsBetweenAddresses(): (ancestorLen == 0) || (ancestor == HLMACAddress::UNSPECIFIED_ADDRESS)!");
 
@@ -27,84 +27,173 @@
 #define IOTORII_SRC_LINKLAYER_COMMON_HLMACADDRESS_H_
 
 #define HLMAC_WIDTH 8
+#define HLMAC_INLINE_LENGTH 16  //number of IDs stored inside the object, deeper addresses spill to the heap
+//#define HLMAC_INTERNED  //uncomment (or compile with -DHLMAC_INTERNED) to share all address prefixes in one global prefix tree
+//#define HLMAC_BENCHMARK  //uncomment (or compile with -DHLMAC_BENCHMARK) to count address copies and heap blocks, see simulations/benchmark
+
+#ifdef HLMAC_BENCHMARK
+#define HLMAC_BENCHMARK_COUNT(counter) (counter)++
+#else
+#define HLMAC_BENCHMARK_COUNT(counter)
+#endif
 
-#include <vector>
 //#include <iterator>
+#include <map>
 #include "inet/common/INETDefs.h"
 
 namespace iotorii {
 using namespace inet;
 
+#ifdef HLMAC_INTERNED
+/*
+ * Node of the global prefix tree of HLMAC_INTERNED addresses. An address is a handle to the node of its last ID,
+ * so a child address shares all IDs with its parent address, and a copy is a pointer copy.
+ */
+struct HLMACPrefixNode
+{
+    HLMACPrefixNode *parent;
+    unsigned int id;          // last ID of the address
+    unsigned int depth;       // number of IDs of the address
+    unsigned int refCount;    // number of addresses and children pointing to this node
+    std::map<unsigned int, HLMACPrefixNode *> children;
+    HLMACPrefixNode(HLMACPrefixNode *parent, unsigned int id) : parent(parent), id(id), depth(parent ? parent->depth + 1 : 0), refCount(0) {}
+};
+#endif
+
 class HLMACAddress {
 
 private:
-    std::vector<unsigned int> address;
+#ifdef HLMAC_INTERNED
+    HLMACPrefixNode *node;
+
+    static HLMACPrefixNode *getRoot();
+
+    static HLMACPrefixNode *getChild(HLMACPrefixNode *parent, unsigned int id);  //creates the child if needed, and retains it
+
+    static HLMACPrefixNode *getAncestor(HLMACPrefixNode *node, unsigned int depth) { while (node->depth > depth) node = node->parent; return node; }
+
+    static void retain(HLMACPrefixNode *node) { node->refCount++; }
+
+    static void release(HLMACPrefixNode *node);
+#else
+    unsigned int length;      // number of IDs in the address
+    unsigned int capacity;    // HLMAC_INLINE_LENGTH while the IDs are stored in inlineIds
+    unsigned int *ids;        // points to inlineIds, or to a heap block for very deep addresses
+    unsigned int inlineIds[HLMAC_INLINE_LENGTH];
+
+    void copyFrom(const HLMACAddress& other);
+
+    void reserve(unsigned int newCapacity);
+
+    void releaseStorage() { if (ids != inlineIds) delete[] ids; ids = inlineIds; capacity = HLMAC_INLINE_LENGTH; }
+#endif
 
 public:
 
+#ifdef HLMAC_BENCHMARK
+  /** Number of heap blocks allocated by addresses deeper than HLMAC_INLINE_LENGTH (HLMAC_INTERNED: prefix tree nodes) */
+  static unsigned long numHeapAllocations;
+
+  /**
+   * Number of address copies (copy construction and assignment). The former std::vector storage allocated
+   * on each of them, but also on default and array construction and on push_back growth, which are not
+   * counted: this is a lower bound of its allocations.
+   */
+  static unsigned long numCopies;
+#endif
+
   /** The unspecified HLMAC address, 0.0.0.0.0.0.0.0 */
   static const HLMACAddress UNSPECIFIED_ADDRESS;
 
   /** The broadcast HLMAC address, 255.255.255.255.255.255.255.255 or FF.FF.FF.FF.FF.FF.FF.FF */
   static const HLMACAddress BROADCAST_ADDRESS;
 
+#ifdef HLMAC_INTERNED
+  HLMACAddress() : node(getChild(getRoot(), 0)) {}
+
+  HLMACAddress(const HLMACAddress& other) : node(other.node) { HLMAC_BENCHMARK_COUNT(numCopies); retain(node); }
+
+  explicit HLMACAddress(const unsigned int array[], unsigned int arrayLength);
+
+  ~HLMACAddress() { release(node); }
+
+  unsigned int getHLMACLength() const { return node->depth; }
+
+  unsigned int getIndexValue(unsigned int k) const { if (k >= node->depth) throw cRuntimeError("HLMACAddress::getIndexValue(): index %u is not in range", k); return getAncestor(node, k + 1)->id; }
+
+  void setIndexValue(unsigned int k, unsigned int addrbyte);
+
+  void addNewId(unsigned int newPortId) { HLMACPrefixNode *child = getChild(node, newPortId); release(node); node = child; }
+
+  void removeLastId() { if (node->depth > 0) { HLMACPrefixNode *parent = node->parent; retain(parent); release(node); node = parent; } }
+
+  HLMACAddress& operator=(const HLMACAddress& other) { HLMAC_BENCHMARK_COUNT(numCopies); retain(other.node); release(node); node = other.node; return *this; }
+#else
   /**
    * Default constructor initializes address bytes to zero.
    */
-  HLMACAddress() { address = {0}; }  //{ address = {0,0,0,0,0,0,0,0}; }
+  HLMACAddress() : length(1), capacity(HLMAC_INLINE_LENGTH), ids(inlineIds) { inlineIds[0] = 0; }  //{ address = {0,0,0,0,0,0,0,0}; }
 
   /**
     * copy constructor
     */
-  HLMACAddress(const HLMACAddress& other) { address = other.address; }
+  HLMACAddress(const HLMACAddress& other) : length(0), capacity(HLMAC_INLINE_LENGTH), ids(inlineIds) { copyFrom(other); }
 
-  explicit HLMACAddress(unsigned int array[])  {  address.insert( address.begin(), array, array + sizeof array);}  //{  address.insert( address.begin(), array, array + sizeof array / sizeof array[0]);} //e.g. HLMACAddress::BROADCAST_ADDRESS({255.255.255.255.255.255.255.255})
+  explicit HLMACAddress(const unsigned int array[], unsigned int arrayLength);  //e.g. HLMACAddress::BROADCAST_ADDRESS({255.255.255.255.255.255.255.255}, 8)
 
-  /**
-   * Returns the address width.
-   */
-  unsigned int getHLMACWidth() const { return HLMAC_WIDTH; }
+  ~HLMACAddress() { releaseStorage(); }
 
   /**
    * Returns the address width.
    */
-  unsigned int getHLMACLength() const { return address.size(); }
+  unsigned int getHLMACLength() const { return length; }
 
     /**
    * Returns the value of index.
    */
-  unsigned int getIndexValue(unsigned int k) const {return address.at(k);}
-
-  /**
-   * Converts address to a string.
-   */
-  std::string str() const;
+  unsigned int getIndexValue(unsigned int k) const { if (k >= length) throw cRuntimeError("HLMACAddress::getIndexValue(): index %u is not in range", k); return ids[k]; }
 
   /**
    * Sets the kth index of the address.
    */
-  void setIndexValue(unsigned int k, unsigned int addrbyte){address.at(k) = addrbyte;}
+  void setIndexValue(unsigned int k, unsigned int addrbyte){ if (k >= length) throw cRuntimeError("HLMACAddress::setIndexValue(): index %u is not in range", k); ids[k] = addrbyte; }
 
   /* add new suffix to frame. note that this method cannot insert new core.
    * for insertion new core, we can directly use setIndexValue(0, core) or setCore()
    */
-  void addNewId(unsigned int newPortId) {address.push_back(newPortId);}
+  void addNewId(unsigned int newPortId) { if (length == capacity) reserve(2 * capacity); ids[length++] = newPortId; }
 
-  void removeLastId() {address.pop_back(); }
+  void removeLastId() { if (length > 0) length--; }
+#endif
 
-  void setCore(unsigned int newCoreId) {address.at(0) = newCoreId;}
+  /**
+   * Returns the address width.
+   */
+  unsigned int getHLMACWidth() const { return HLMAC_WIDTH; }
+
+  /**
+   * Converts address to a string.
+   */
+  std::string str() const;
+
+  void setCore(unsigned int newCoreId) { setIndexValue(0, newCoreId); }
 
   //Used for hopCount metric
   HLMACAddress getLongestCommonPrefix(const HLMACAddress &other);
 
+  //Used for hopCount metric, the number of leading IDs shared with other (getLongestCommonPrefix() without building the prefix)
+  unsigned int getLongestCommonPrefixLength(const HLMACAddress &other) const;
+
   //Used for hopCount metric
-  int numHopsBetweenAddresses(const HLMACAddress &other);
+  int numHopsBetweenAddresses(const HLMACAddress &other) const;
 
   //unsigned short int getHLMACHier();
+#ifndef HLMAC_INTERNED
   /**
    * Assignment.
    */
-  HLMACAddress& operator=(const HLMACAddress& other) { address = other.address; return *this; }
+  HLMACAddress& operator=(const HLMACAddress& other) { if (this != &other) copyFrom(other); return *this; }
+#endif
 
   /**
    * Returns -1, 0 or 1 as result of comparison of 2 addresses.
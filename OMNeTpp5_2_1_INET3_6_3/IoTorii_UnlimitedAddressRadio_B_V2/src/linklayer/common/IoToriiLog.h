@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2018 Elisa Rojas(1), Hedayat Hosseini(2);
+ *                    (1) GIST, University of Alcala, Spain.
+ *                    (2) CEIT, Amirkabir University of Technology (Tehran Polytechnic), Iran.
+ *                    OMNeT++ 5.2.1 & INET 3.6.3
+*/
+
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef IOTORII_SRC_LINKLAYER_COMMON_IOTORIILOG_H_
+#define IOTORII_SRC_LINKLAYER_COMMON_IOTORIILOG_H_
+
+#include "inet/common/INETDefs.h"
+
+/*
+ * Logging of the IoTorii modules. Each module logs in its own category:
+ *   OPERATION  IoToriiOperation        ("IoToriiOperation")
+ *   TABLE      HLMACAddressTable       ("HLMACAddressTable")
+ *   MEDIUM     SimpleIdealRadioMedium  ("SimpleIdealRadioMedium")
+ *   ND         IPv6NeighbourDiscoveryIoTorii ("IPv6NeighbourDiscoveryIoTorii")
+ *
+ * A log line is compiled in if its level is at least IOTORII_LOGLEVEL_<category>, which defaults
+ * to IOTORII_LOGLEVEL, itself COMPILETIME_LOGLEVEL of OMNeT++ (TRACE in debug builds, DETAIL in
+ * release builds). A removed line costs nothing, its arguments are not evaluated. For example,
+ * compile with -DIOTORII_LOGLEVEL=omnetpp::LOGLEVEL_OFF to strip all of them, or with
+ * -DIOTORII_LOGLEVEL_MEDIUM=omnetpp::LOGLEVEL_WARN to keep only the warnings of the radio medium.
+ * The lines compiled in are filtered at runtime like EV (e.g. **.cmdenv-log-level), and the
+ * category can be used in the log prefix (%c).
+ */
+#ifndef IOTORII_LOGLEVEL
+#define IOTORII_LOGLEVEL COMPILETIME_LOGLEVEL
+#endif
+
+#ifndef IOTORII_LOGLEVEL_OPERATION
+#define IOTORII_LOGLEVEL_OPERATION IOTORII_LOGLEVEL
+#endif
+#ifndef IOTORII_LOGLEVEL_TABLE
+#define IOTORII_LOGLEVEL_TABLE IOTORII_LOGLEVEL
+#endif
+#ifndef IOTORII_LOGLEVEL_MEDIUM
+#define IOTORII_LOGLEVEL_MEDIUM IOTORII_LOGLEVEL
+#endif
+#ifndef IOTORII_LOGLEVEL_ND
+#define IOTORII_LOGLEVEL_ND IOTORII_LOGLEVEL
+#endif
+
+#define IOTORII_LOGCATEGORY_OPERATION "IoToriiOperation"
+#define IOTORII_LOGCATEGORY_TABLE "HLMACAddressTable"
+#define IOTORII_LOGCATEGORY_MEDIUM "SimpleIdealRadioMedium"
+#define IOTORII_LOGCATEGORY_ND "IPv6NeighbourDiscoveryIoTorii"
+
+#define IOTORII_LOG(category, loglevel) \
+    if (!((loglevel) >= IOTORII_LOGLEVEL_##category)) ; else EV_LOG(loglevel, IOTORII_LOGCATEGORY_##category)
+
+#define IOTORII_EV_FATAL(category) IOTORII_LOG(category, omnetpp::LOGLEVEL_FATAL)
+#define IOTORII_EV_ERROR(category) IOTORII_LOG(category, omnetpp::LOGLEVEL_ERROR)
+#define IOTORII_EV_WARN(category) IOTORII_LOG(category, omnetpp::LOGLEVEL_WARN)
+#define IOTORII_EV_INFO(category) IOTORII_LOG(category, omnetpp::LOGLEVEL_INFO)
+#define IOTORII_EV_DETAIL(category) IOTORII_LOG(category, omnetpp::LOGLEVEL_DETAIL)
+#define IOTORII_EV_DEBUG(category) IOTORII_LOG(category, omnetpp::LOGLEVEL_DEBUG)
+#define IOTORII_EV_TRACE(category) IOTORII_LOG(category, omnetpp::LOGLEVEL_TRACE)
+#define IOTORII_EV(category) IOTORII_EV_INFO(category)    //same level as EV
+
+#endif // ifndef IOTORII_SRC_LINKLAYER_COMMON_IOTORIILOG_H_
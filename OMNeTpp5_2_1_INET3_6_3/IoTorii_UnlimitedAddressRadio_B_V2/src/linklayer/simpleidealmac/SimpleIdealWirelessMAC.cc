@@ -64,7 +64,8 @@ void SimpleIdealWirelessMAC::initialize(int stage)
 
 
         initializeMACAddress();
-        registerInterface();
+        if (*par("interfaceTableModule").stringValue())  //WSNHostIoToriiLite has no interface table
+            registerInterface();
 
     }
     else if (stage == INITSTAGE_LINK_LAYER) {
@@ -124,9 +125,14 @@ void SimpleIdealWirelessMAC::handleUpperPacket(cPacket *msg)
     //MacPkt*macPkt = encapsMsg(msg);
     MACFrameBase *macPkt = check_and_cast<MACFrameBase *>(msg);
 
-    if ((strcmp(macPkt->getName(), "Hello!") == 0) || (strcmp(macPkt->getName(), "SetHLMAC") == 0)){
+    switch (macPkt->getKind()) {
+    case IOTORII_HELLO:
+    case IOTORII_SETHLMAC:
         macPkt->setSrcAddr(address);
         EV << macPkt->getName() << " packet is received from IoTorii sublayer, source MAC address is "<< macPkt->getSrcAddr() <<endl;
+        break;
+    default:
+        break;
     }
 
     sendDown(msg);
@@ -161,14 +167,19 @@ void SimpleIdealWirelessMAC::handleLowerPacket(cPacket *msg)
 
     if (macPkt->getDestAddr().isBroadcast()){
         EV_DETAIL << "Destination MAC adress is broadcast" << macPkt->getDestAddr() <<", send up packet." << endl;
-        if (strcmp(macPkt->getName(), "Hello!") == 0){//
+        switch (macPkt->getKind()) {
+        case IOTORII_HELLO:
             EV_DETAIL << "Received a Hello packet addressed from MAC adress " << macPkt->getSrcAddr() << endl;
             sendUp(macPkt);
-        }else if (strcmp(macPkt->getName(), "SetHLMAC") == 0){
+            break;
+        case IOTORII_SETHLMAC:
             EV_DETAIL << "Received a SetHLMAC, from " << macPkt->getSrcAddr() << endl;
             sendUp(macPkt);
-        }else    //if other broadcast packets
+            break;
+        default:    //if other broadcast packets
             delete msg;
+            break;
+        }
     }else    //if other unicast packets
         delete msg;
 }
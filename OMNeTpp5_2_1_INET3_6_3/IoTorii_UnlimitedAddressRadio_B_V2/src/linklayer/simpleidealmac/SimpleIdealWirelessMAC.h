@@ -28,6 +28,7 @@
 #include "inet/linklayer/base/MACProtocolBase.h"
 //#include "src/linklayer/simpleidealmac/MACFrameIoTorii_m.h"
 #include "inet/linklayer/base/MACFrameBase_m.h"
+#include "src/linklayer/IoTorii/SetHLMCFrame_m.h"
 
 
 namespace iotorii {
@@ -27,6 +27,7 @@
 //#include "inet/networklayer/icmpv6/IPv6NeighbourDiscovery.h"
 #include "src/networklayer/icmpv6/IPv6NeighbourDiscoveryIoTorii.h"
 #include "src/networklayer/contract/ipv6/IPv6ControlInfoICMP_m.h"
+#include "src/linklayer/common/IoToriiLog.h"
 //EXTRA END
 
 #include "inet/networklayer/contract/ipv6/IPv6ControlInfo.h"
@@ -98,7 +99,7 @@ IPv6NeighbourDiscoveryIoTorii::~IPv6NeighbourDiscoveryIoTorii()
 
 void IPv6NeighbourDiscoveryIoTorii::initialize(int stage)
 {
-    EV << "->IPv6NeighbourDiscoveryIoTorii::initialize()" << endl;  //EXTRA
+    IOTORII_EV(ND) << "->IPv6NeighbourDiscoveryIoTorii::initialize()" << endl;  //EXTRA
     cSimpleModule::initialize(stage);
 
     if (stage == INITSTAGE_NETWORK_LAYER) {
@@ -165,18 +166,18 @@ void IPv6NeighbourDiscoveryIoTorii::initialize(int stage)
                     continue;
 
                 IPv6Address linkLocalAddr = ie->ipv6Data()->getLinkLocalAddress();
-                EV << "Assigned link local address is: " << linkLocalAddr << endl;
+                IOTORII_EV(ND) << "Assigned link local address is: " << linkLocalAddr << endl;
                 if (linkLocalAddr.isUnspecified()) {
                     //if no link local address exists for this interface, we assign one to it.
-                    EV_INFO << "No link local address exists. Forming one" << endl;
+                    IOTORII_EV_INFO(ND) << "No link local address exists. Forming one" << endl;
                     linkLocalAddr = IPv6Address().formLinkLocalAddress(ie->getInterfaceToken());
                     ie->ipv6Data()->assignAddress(linkLocalAddr, true, SIMTIME_ZERO, SIMTIME_ZERO);
-                    EV << "Assigned link local address is: " << linkLocalAddr << endl;
+                    IOTORII_EV(ND) << "Assigned link local address is: " << linkLocalAddr << endl;
                 }
 
                 //Before we can use this address, an error is generated.
                 if (ie->ipv6Data()->isTentativeAddress(linkLocalAddr)) {
-                    EV << "The tentative link local address is changed to the permanent link local address." << endl;
+                    IOTORII_EV(ND) << "The tentative link local address is changed to the permanent link local address." << endl;
                     ie->ipv6Data()->permanentlyAssign(linkLocalAddr);
                 }
             }
@@ -194,44 +195,44 @@ void IPv6NeighbourDiscoveryIoTorii::initialize(int stage)
         //EXTRA END
 
     }
-    EV << "<-IPv6NeighbourDiscoveryIoTorii::initialize()" << endl;  //EXTRA
+    IOTORII_EV(ND) << "<-IPv6NeighbourDiscoveryIoTorii::initialize()" << endl;  //EXTRA
 }
 
 void IPv6NeighbourDiscoveryIoTorii::handleMessage(cMessage *msg)
 {
     if (msg->isSelfMessage()) {
-        EV_TRACE << "Self message received!\n";
+        IOTORII_EV_TRACE(ND) << "Self message received!\n";
 
         if (msg->getKind() == MK_SEND_PERIODIC_RTRADV) {
-            EV_INFO << "Sending periodic RA\n";
+            IOTORII_EV_INFO(ND) << "Sending periodic RA\n";
             sendPeriodicRA(msg);
         }
         else if (msg->getKind() == MK_SEND_SOL_RTRADV) {
-            EV_INFO << "Sending solicited RA\n";
+            IOTORII_EV_INFO(ND) << "Sending solicited RA\n";
             sendSolicitedRA(msg);
         }
         else if (msg->getKind() == MK_ASSIGN_LINKLOCAL_ADDRESS) {
-            EV_INFO << "Assigning Link Local Address\n";
+            IOTORII_EV_INFO(ND) << "Assigning Link Local Address\n";
             assignLinkLocalAddress(msg);
         }
         else if (msg->getKind() == MK_DAD_TIMEOUT) {
-            EV_INFO << "DAD Timeout message received\n";
+            IOTORII_EV_INFO(ND) << "DAD Timeout message received\n";
             processDADTimeout(msg);
         }
         else if (msg->getKind() == MK_RD_TIMEOUT) {
-            EV_INFO << "Router Discovery message received\n";
+            IOTORII_EV_INFO(ND) << "Router Discovery message received\n";
             processRDTimeout(msg);
         }
         else if (msg->getKind() == MK_INITIATE_RTRDIS) {
-            EV_INFO << "initiate router discovery.\n";
+            IOTORII_EV_INFO(ND) << "initiate router discovery.\n";
             initiateRouterDiscovery(msg);
         }
         else if (msg->getKind() == MK_NUD_TIMEOUT) {
-            EV_INFO << "NUD Timeout message received\n";
+            IOTORII_EV_INFO(ND) << "NUD Timeout message received\n";
             processNUDTimeout(msg);
         }
         else if (msg->getKind() == MK_AR_TIMEOUT) {
-            EV_INFO << "Address Resolution Timeout message received\n";
+            IOTORII_EV_INFO(ND) << "Address Resolution Timeout message received\n";
             processARTimeout(msg);
         }
         else
@@ -289,7 +290,7 @@ void IPv6NeighbourDiscoveryIoTorii::finish()
 
 void IPv6NeighbourDiscoveryIoTorii::processIPv6Datagram(IPv6Datagram *msg)
 {
-    EV_INFO << "Packet " << msg << " arrived from IPv6 module.\n";
+    IOTORII_EV_INFO(ND) << "Packet " << msg << " arrived from IPv6 module.\n";
 
     IPv6NDControlInfo *ctrl = check_and_cast<IPv6NDControlInfo *>(msg->getControlInfo());
     int nextHopIfID = ctrl->getInterfaceId();
@@ -297,7 +298,7 @@ void IPv6NeighbourDiscoveryIoTorii::processIPv6Datagram(IPv6Datagram *msg)
     //bool fromHL = ctrl->getFromHL();
 
     if (nextHopIfID == -1 || nextHopAddr.isUnspecified()) {
-        EV_INFO << "Determining Next Hop" << endl;
+        IOTORII_EV_INFO(ND) << "Determining Next Hop" << endl;
         nextHopAddr = determineNextHop(msg->getDestAddress(), nextHopIfID);
         ctrl->setInterfaceId(nextHopIfID);
         ctrl->setNextHop(nextHopAddr);
@@ -311,7 +312,7 @@ void IPv6NeighbourDiscoveryIoTorii::processIPv6Datagram(IPv6Datagram *msg)
         return;
     }
 
-    EV_INFO << "Next Hop Address is: " << nextHopAddr << " on interface: " << nextHopIfID << endl;
+    IOTORII_EV_INFO(ND) << "Next Hop Address is: " << nextHopAddr << " on interface: " << nextHopIfID << endl;
 
     //RFC2461: Section 5.2 Conceptual Sending Algorithm
     //Once the IP address of the next-hop node is known, the sender examines the
@@ -319,20 +320,20 @@ void IPv6NeighbourDiscoveryIoTorii::processIPv6Datagram(IPv6Datagram *msg)
     Neighbour *nce = neighbourCache.lookup(nextHopAddr, nextHopIfID);
 
     if (nce == nullptr) {
-        EV_INFO << "No Entry exists in the Neighbour Cache.\n";
+        IOTORII_EV_INFO(ND) << "No Entry exists in the Neighbour Cache.\n";
         InterfaceEntry *ie = ift->getInterfaceById(nextHopIfID);
         if (ie->isPointToPoint()) {
             //the sender creates one, sets its state to STALE,
-            EV_DETAIL << "Creating an STALE entry in the neighbour cache.\n";
+            IOTORII_EV_DETAIL(ND) << "Creating an STALE entry in the neighbour cache.\n";
             nce = neighbourCache.addNeighbour(nextHopAddr, nextHopIfID, MACAddress::UNSPECIFIED_ADDRESS);
         }
         else {
             //the sender creates one, sets its state to INCOMPLETE,
-            EV_DETAIL << "Creating an INCOMPLETE entry in the neighbour cache.\n";
+            IOTORII_EV_DETAIL(ND) << "Creating an INCOMPLETE entry in the neighbour cache.\n";
             nce = neighbourCache.addNeighbour(nextHopAddr, nextHopIfID);
 
             //initiates Address Resolution,
-            EV_DETAIL << "Initiating Address Resolution for:" << nextHopAddr
+            IOTORII_EV_DETAIL(ND) << "Initiating Address Resolution for:" << nextHopAddr
                       << " on Interface:" << nextHopIfID << endl;
             initiateAddressResolution(msg->getSrcAddress(), nce);
         }
@@ -345,27 +346,27 @@ void IPv6NeighbourDiscoveryIoTorii::processIPv6Datagram(IPv6Datagram *msg)
      */
     switch (nce->reachabilityState) {
     case IPv6NeighbourCacheIoTorii::INCOMPLETE:
-        EV_INFO << "Reachability State is INCOMPLETE. Address Resolution already initiated.\n";
-        EV_INFO << "Add packet to entry's queue until Address Resolution is complete.\n";
+        IOTORII_EV_INFO(ND) << "Reachability State is INCOMPLETE. Address Resolution already initiated.\n";
+        IOTORII_EV_INFO(ND) << "Add packet to entry's queue until Address Resolution is complete.\n";
         bubble("Packet added to queue until Address Resolution is complete.");
         nce->pendingPackets.push_back(msg);
         pendingQueue.insert(msg);
         break;
     case IPv6NeighbourCacheIoTorii::STALE:
-        EV_INFO << "Reachability State is STALE.\n";
+        IOTORII_EV_INFO(ND) << "Reachability State is STALE.\n";
         send(msg, "ipv6Out");
         initiateNeighbourUnreachabilityDetection(nce);
         break;
     case IPv6NeighbourCacheIoTorii::REACHABLE:
-        EV_INFO << "Next hop is REACHABLE, sending packet to next-hop address.";
+        IOTORII_EV_INFO(ND) << "Next hop is REACHABLE, sending packet to next-hop address.";
         send(msg, "ipv6Out");
         break;
     case IPv6NeighbourCacheIoTorii::DELAY:
-        EV_INFO << "Next hop is in DELAY state, sending packet to next-hop address.";
+        IOTORII_EV_INFO(ND) << "Next hop is in DELAY state, sending packet to next-hop address.";
         send(msg, "ipv6Out");
         break;
     case IPv6NeighbourCacheIoTorii::PROBE:
-        EV_INFO << "Next hop is in PROBE state, sending packet to next-hop address.";
+        IOTORII_EV_INFO(ND) << "Next hop is in PROBE state, sending packet to next-hop address.";
         send(msg, "ipv6Out");
         break;
     default:
@@ -418,7 +419,7 @@ const MACAddress& IPv6NeighbourDiscoveryIoTorii::resolveNeighbour(const IPv6Addr
         //reachability state must be either in DELAY or PROBE
         ASSERT(nce->reachabilityState == IPv6NeighbourCacheIoTorii::DELAY ||
                 nce->reachabilityState == IPv6NeighbourCacheIoTorii::PROBE);
-        EV_INFO << "NUD in progress.\n";
+        IOTORII_EV_INFO(ND) << "NUD in progress.\n";
     }
 
     //else the entry is REACHABLE and no further action is required here.
@@ -437,7 +438,7 @@ void IPv6NeighbourDiscoveryIoTorii::reachabilityConfirmed(const IPv6Address& nei
 
     cMessage *msg = nce->nudTimeoutEvent;
     if (msg != nullptr) {
-        EV_INFO << "NUD in progress. Cancelling NUD Timer\n";
+        IOTORII_EV_INFO(ND) << "NUD in progress. Cancelling NUD Timer\n";
         bubble("Reachability Confirmed via NUD.");
         cancelAndDelete(msg);
         nce->nudTimeoutEvent = nullptr;
@@ -503,7 +504,7 @@ IPv6Address IPv6NeighbourDiscoveryIoTorii::determineNextHop(const IPv6Address& d
 
     //The sender performs a longest prefix match against the Prefix List to
     //determine whether the packet's destination is on- or off-link.
-    EV_INFO << "Find out if supplied dest addr is on-link or off-link.\n";
+    IOTORII_EV_INFO(ND) << "Find out if supplied dest addr is on-link or off-link.\n";
     const IPv6Route *route = rt6->doLongestPrefixMatch(destAddr);
 
     if (route != nullptr) {
@@ -513,12 +514,12 @@ IPv6Address IPv6NeighbourDiscoveryIoTorii::determineNextHop(const IPv6Address& d
         //If the destination is on-link, the next-hop address is the same as the
         //packet's destination address.
         if (route->getNextHop().isUnspecified()) {
-            EV_INFO << "Dest is on-link, next-hop addr is same as dest addr.\n";
+            IOTORII_EV_INFO(ND) << "Dest is on-link, next-hop addr is same as dest addr.\n";
             nextHopAddr = destAddr;
         }
         else {
-            EV_INFO << "A next-hop address was found with the route, dest is off-link\n";
-            EV_INFO << "Assume next-hop address as the selected default router.\n";
+            IOTORII_EV_INFO(ND) << "A next-hop address was found with the route, dest is off-link\n";
+            IOTORII_EV_INFO(ND) << "Assume next-hop address as the selected default router.\n";
             nextHopAddr = route->getNextHop();
         }
     }
@@ -526,14 +527,14 @@ IPv6Address IPv6NeighbourDiscoveryIoTorii::determineNextHop(const IPv6Address& d
         //Otherwise, the sender selects a router from the Default Router List
         //(following the rules described in Section 6.3.6).
 
-        EV_INFO << "No routes were found, Dest addr is off-link.\n";
+        IOTORII_EV_INFO(ND) << "No routes were found, Dest addr is off-link.\n";
         nextHopAddr = selectDefaultRouter(outIfID);
         expiryTime = 0;
 
         if (outIfID == -1)
-            EV_INFO << "No Default Routers were found.";
+            IOTORII_EV_INFO(ND) << "No Default Routers were found.";
         else
-            EV_INFO << "Default router found.\n";
+            IOTORII_EV_INFO(ND) << "Default router found.\n";
     }
 
     /*the results of next-hop determination computations are saved in the Destination
@@ -547,9 +548,9 @@ void IPv6NeighbourDiscoveryIoTorii::initiateNeighbourUnreachabilityDetection(Nei
     ASSERT(nce->reachabilityState == IPv6NeighbourCacheIoTorii::STALE);
     ASSERT(nce->nudTimeoutEvent == nullptr);
     const Key *nceKey = nce->nceKey;
-    EV_INFO << "Initiating Neighbour Unreachability Detection";
+    IOTORII_EV_INFO(ND) << "Initiating Neighbour Unreachability Detection";
     InterfaceEntry *ie = ift->getInterfaceById(nceKey->interfaceID);
-    EV_INFO << "Setting NCE state to DELAY.\n";
+    IOTORII_EV_INFO(ND) << "Setting NCE state to DELAY.\n";
     /*The first time a node sends a packet to a neighbor whose entry is
        STALE, the sender changes the state to DELAY*/
     nce->reachabilityState = IPv6NeighbourCacheIoTorii::DELAY;
@@ -563,7 +564,7 @@ void IPv6NeighbourDiscoveryIoTorii::initiateNeighbourUnreachabilityDetection(Nei
 
 void IPv6NeighbourDiscoveryIoTorii::processNUDTimeout(cMessage *timeoutMsg)
 {
-    EV_INFO << "NUD has timed out\n";
+    IOTORII_EV_INFO(ND) << "NUD has timed out\n";
     Neighbour *nce = (Neighbour *)timeoutMsg->getContextPointer();
 
     const Key *nceKey = nce->nceKey;
@@ -577,8 +578,8 @@ void IPv6NeighbourDiscoveryIoTorii::processNUDTimeout(cMessage *timeoutMsg)
         /*If the entry is still in the DELAY state when the timer expires, the
            entry's state changes to PROBE. If reachability confirmation is received,
            the entry's state changes to REACHABLE.*/
-        EV_DETAIL << "Neighbour Entry is still in DELAY state.\n";
-        EV_DETAIL << "Entering PROBE state. Sending NS probe.\n";
+        IOTORII_EV_DETAIL(ND) << "Neighbour Entry is still in DELAY state.\n";
+        IOTORII_EV_DETAIL(ND) << "Entering PROBE state. Sending NS probe.\n";
         nce->reachabilityState = IPv6NeighbourCacheIoTorii::PROBE;
         nce->numProbesSent = 0;
     }
@@ -588,8 +589,8 @@ void IPv6NeighbourDiscoveryIoTorii::processNUDTimeout(cMessage *timeoutMsg)
        and the entry SHOULD be deleted. Subsequent traffic to that neighbor will
        recreate the entry and performs address resolution again.*/
     if (nce->numProbesSent == (int)ie->ipv6Data()->_getMaxUnicastSolicit()) {
-        EV_DETAIL << "Max number of probes have been sent." << endl;
-        EV_DETAIL << "Neighbour is Unreachable, removing NCE." << endl;
+        IOTORII_EV_DETAIL(ND) << "Max number of probes have been sent." << endl;
+        IOTORII_EV_DETAIL(ND) << "Neighbour is Unreachable, removing NCE." << endl;
         neighbourCache.remove(nceKey->address, nceKey->interfaceID); // remove nce from cache, cancel and delete timeoutMsg;
         return;
     }
@@ -608,7 +609,7 @@ void IPv6NeighbourDiscoveryIoTorii::processNUDTimeout(cMessage *timeoutMsg)
 
 IPv6Address IPv6NeighbourDiscoveryIoTorii::selectDefaultRouter(int& outIfID)
 {
-    EV_INFO << "Selecting default router...\n";
+    IOTORII_EV_INFO(ND) << "Selecting default router...\n";
     //draft-ietf-ipv6-2461bis-04.txt Section 6.3.6
     /*The algorithm for selecting a router depends in part on whether or not a
        router is known to be reachable. The exact details of how a node keeps track
@@ -635,13 +636,13 @@ IPv6Address IPv6NeighbourDiscoveryIoTorii::selectDefaultRouter(int& outIfID)
     for (auto it = defaultRouters.begin(); it != defaultRouters.end(); ) {
         Neighbour& nce = *it;
         if (simTime() > nce.routerExpiryTime) {
-            EV_INFO << "Found an expired default router. Deleting entry...\n";
+            IOTORII_EV_INFO(ND) << "Found an expired default router. Deleting entry...\n";
             ++it;
             neighbourCache.remove(nce.nceKey->address, nce.nceKey->interfaceID);
             continue;
         }
         if (nce.reachabilityState != IPv6NeighbourCacheIoTorii::INCOMPLETE) {
-            EV_INFO << "Found a probably reachable router in the default router list.\n";
+            IOTORII_EV_INFO(ND) << "Found a probably reachable router in the default router list.\n";
             defaultRouters.setHead(*nce.nextDefaultRouter);
             outIfID = nce.nceKey->interfaceID;
             return nce.nceKey->address;
@@ -661,13 +662,13 @@ IPv6Address IPv6NeighbourDiscoveryIoTorii::selectDefaultRouter(int& outIfID)
        as a side effect.*/
     Neighbour *defaultRouter = defaultRouters.getHead();
     if (defaultRouter != nullptr) {
-        EV_INFO << "Found a router in the neighbour cache (default router list).\n";
+        IOTORII_EV_INFO(ND) << "Found a router in the neighbour cache (default router list).\n";
         defaultRouters.setHead(*defaultRouter->nextDefaultRouter);
         outIfID = defaultRouter->nceKey->interfaceID;
         return defaultRouter->nceKey->address;
     }
 
-    EV_INFO << "No suitable routers found.\n";
+    IOTORII_EV_INFO(ND) << "No suitable routers found.\n";
     outIfID = -1;
     return IPv6Address::UNSPECIFIED_ADDRESS;
 }
@@ -722,8 +723,8 @@ void IPv6NeighbourDiscoveryIoTorii::initiateAddressResolution(const IPv6Address&
     //neighbor.  The solicitation is sent to the solicited-node multicast
     //address "corresponding to"(or "derived from") the target address.
     //(in this case, the target address is the address we are trying to resolve)
-    EV_INFO << "Preparing to send NS to solicited-node multicast group\n";
-    EV_INFO << "on the next hop interface\n";
+    IOTORII_EV_INFO(ND) << "Preparing to send NS to solicited-node multicast group\n";
+    IOTORII_EV_INFO(ND) << "on the next hop interface\n";
     IPv6Address nsDestAddr = neighbourAddr.formSolicitedNodeMulticastAddress();    //for NS datagram
     IPv6Address nsTargetAddr = neighbourAddr;    //for the field within the NS
     IPv6Address nsSrcAddr;
@@ -761,11 +762,11 @@ void IPv6NeighbourDiscoveryIoTorii::processARTimeout(cMessage *arTimeoutMsg)
     const Key *nceKey = nce->nceKey;
     IPv6Address nsTargetAddr = nceKey->address;
     InterfaceEntry *ie = ift->getInterfaceById(nceKey->interfaceID);
-    EV_INFO << "Num Of NS Sent:" << nce->numOfARNSSent << endl;
-    EV_INFO << "Max Multicast Solicitation:" << ie->ipv6Data()->_getMaxMulticastSolicit() << endl;
+    IOTORII_EV_INFO(ND) << "Num Of NS Sent:" << nce->numOfARNSSent << endl;
+    IOTORII_EV_INFO(ND) << "Max Multicast Solicitation:" << ie->ipv6Data()->_getMaxMulticastSolicit() << endl;
 
     if (nce->numOfARNSSent < ie->ipv6Data()->_getMaxMulticastSolicit()) {
-        EV_INFO << "Sending another Address Resolution NS message" << endl;
+        IOTORII_EV_INFO(ND) << "Sending another Address Resolution NS message" << endl;
         IPv6Address nsDestAddr = nsTargetAddr.formSolicitedNodeMulticastAddress();
         createAndSendNSPacket(nsTargetAddr, nsDestAddr, nce->nsSrcAddr, ie);
         nce->numOfARNSSent++;
@@ -773,9 +774,9 @@ void IPv6NeighbourDiscoveryIoTorii::processARTimeout(cMessage *arTimeoutMsg)
         return;
     }
 
-    EV_WARN << "Address Resolution has failed." << endl;
+    IOTORII_EV_WARN(ND) << "Address Resolution has failed." << endl;
     dropQueuedPacketsAwaitingAR(nce);
-    EV_INFO << "Deleting AR timeout msg\n";
+    IOTORII_EV_INFO(ND) << "Deleting AR timeout msg\n";
     delete arTimeoutMsg;
 }
 
@@ -788,7 +789,7 @@ void IPv6NeighbourDiscoveryIoTorii::dropQueuedPacketsAwaitingAR(Neighbour *nce)
        destination unreachable indications with code 3 (Address Unreachable) for
        each packet queued awaiting address resolution.*/
     MsgPtrVector& pendingPackets = nce->pendingPackets;
-    EV_INFO << "Pending Packets empty:" << pendingPackets.empty() << endl;
+    IOTORII_EV_INFO(ND) << "Pending Packets empty:" << pendingPackets.empty() << endl;
 
     while (!pendingPackets.empty()) {
         auto i = pendingPackets.begin();
@@ -796,7 +797,7 @@ void IPv6NeighbourDiscoveryIoTorii::dropQueuedPacketsAwaitingAR(Neighbour *nce)
         IPv6Datagram *ipv6Msg = check_and_cast<IPv6Datagram *>(msg);
         //Assume msg is the packet itself. I need the datagram's source addr.
         //The datagram's src addr will be the destination of the unreachable msg.
-        EV_INFO << "Sending ICMP unreachable destination." << endl;
+        IOTORII_EV_INFO(ND) << "Sending ICMP unreachable destination." << endl;
         pendingPackets.erase(i);
         pendingQueue.remove(msg);
         icmpv6->sendErrorMessage(ipv6Msg, ICMPv6_DESTINATION_UNREACHABLE, ADDRESS_UNREACHABLE);
@@ -805,7 +806,7 @@ void IPv6NeighbourDiscoveryIoTorii::dropQueuedPacketsAwaitingAR(Neighbour *nce)
     //RFC 2461: Section 7.3.3
     /*If address resolution fails, the entry SHOULD be deleted, so that subsequent
        traffic to that neighbor invokes the next-hop determination procedure again.*/
-    EV_INFO << "Removing neighbour cache entry" << endl;
+    IOTORII_EV_INFO(ND) << "Removing neighbour cache entry" << endl;
     neighbourCache.remove(nceKey->address, nceKey->interfaceID);
 }
 
@@ -835,14 +836,14 @@ void IPv6NeighbourDiscoveryIoTorii::sendQueuedPacketsToIPv6Module(Neighbour *nce
         cMessage *msg = (*i);
         pendingPackets.erase(i);
         pendingQueue.remove(msg);
-        EV_INFO << "Sending queued packet " << msg << endl;
+        IOTORII_EV_INFO(ND) << "Sending queued packet " << msg << endl;
         send(msg, "ipv6Out");
     }
 }
 
 void IPv6NeighbourDiscoveryIoTorii::assignLinkLocalAddress(cMessage *timerMsg)
 {
-    EV << "-> IPv6NeighbourDiscoveryIoTorii::assignLinkLocalAddress()" << endl;  //EXTRA
+    IOTORII_EV(ND) << "-> IPv6NeighbourDiscoveryIoTorii::assignLinkLocalAddress()" << endl;  //EXTRA
     //Node has booted up. Start assigning a link-local address for each
     //interface in this node.
     for (int i = 0; i < ift->getNumInterfaces(); i++) {
@@ -853,10 +854,10 @@ void IPv6NeighbourDiscoveryIoTorii::assignLinkLocalAddress(cMessage *timerMsg)
             continue;
 
         IPv6Address linkLocalAddr = ie->ipv6Data()->getLinkLocalAddress();
-        EV << "Link local address is: " << linkLocalAddr << endl;  //EXTRA
+        IOTORII_EV(ND) << "Link local address is: " << linkLocalAddr << endl;  //EXTRA
         if (linkLocalAddr.isUnspecified()) {
             //if no link local address exists for this interface, we assign one to it.
-            EV_INFO << "No link local address exists. Forming one" << endl;
+            IOTORII_EV_INFO(ND) << "No link local address exists. Forming one" << endl;
             linkLocalAddr = IPv6Address().formLinkLocalAddress(ie->getInterfaceToken());
             ie->ipv6Data()->assignAddress(linkLocalAddr, true, SIMTIME_ZERO, SIMTIME_ZERO);
         }
@@ -870,14 +871,14 @@ void IPv6NeighbourDiscoveryIoTorii::assignLinkLocalAddress(cMessage *timerMsg)
         }
     }
     delete timerMsg;
-    EV << "<- IPv6NeighbourDiscoveryIoTorii::assignLinkLocalAddress()" << endl;  //EXTRA
+    IOTORII_EV(ND) << "<- IPv6NeighbourDiscoveryIoTorii::assignLinkLocalAddress()" << endl;  //EXTRA
 }
 
 void IPv6NeighbourDiscoveryIoTorii::initiateDAD(const IPv6Address& tentativeAddr, InterfaceEntry *ie)
 {
 #ifdef WITH_xMIPv6
     Enter_Method_Silent();
-    EV_INFO << "----------INITIATING DUPLICATE ADDRESS DISCOVERY----------" << endl;
+    IOTORII_EV_INFO(ND) << "----------INITIATING DUPLICATE ADDRESS DISCOVERY----------" << endl;
     ie->ipv6Data()->setDADInProgress(true);
 #endif /* WITH_xMIPv6 */
 
@@ -921,8 +922,8 @@ void IPv6NeighbourDiscoveryIoTorii::processDADTimeout(cMessage *msg)
     IPv6Address tentativeAddr = dadEntry->address;
     //Here, we need to check how many DAD messages for the interface entry were
     //sent vs. DupAddrDetectTransmits
-    EV_DETAIL << "numOfDADMessagesSent is: " << dadEntry->numNSSent << endl;
-    EV_DETAIL << "dupAddrDetectTrans is: " << ie->ipv6Data()->getDupAddrDetectTransmits() << endl;
+    IOTORII_EV_DETAIL(ND) << "numOfDADMessagesSent is: " << dadEntry->numNSSent << endl;
+    IOTORII_EV_DETAIL(ND) << "dupAddrDetectTrans is: " << ie->ipv6Data()->getDupAddrDetectTransmits() << endl;
 
     if (dadEntry->numNSSent < ie->ipv6Data()->getDupAddrDetectTransmits()) {
         bubble("Sending another DAD NS message.");
@@ -935,7 +936,7 @@ void IPv6NeighbourDiscoveryIoTorii::processDADTimeout(cMessage *msg)
     else {
         bubble("Max number of DAD messages for interface sent. Address is unique.");
         dadList.erase(dadEntry);
-        EV_DETAIL << "delete dadEntry and msg\n";
+        IOTORII_EV_DETAIL(ND) << "delete dadEntry and msg\n";
         delete dadEntry;
         delete msg;
 
@@ -1015,7 +1016,7 @@ void IPv6NeighbourDiscoveryIoTorii::makeTentativeAddressPermanent(const IPv6Addr
     //TODO: Placing these operations here means fast router solicitation is
     //not adopted. Will relocate.
     if (ie->ipv6Data()->getAdvSendAdvertisements() == false) {
-        EV_INFO << "creating router discovery message timer\n";
+        IOTORII_EV_INFO(ND) << "creating router discovery message timer\n";
         cMessage *rtrDisMsg = new cMessage("initiateRTRDIS", MK_INITIATE_RTRDIS);
         rtrDisMsg->setContextPointer(ie);
         simtime_t interval = uniform(0, ie->ipv6Data()->_getMaxRtrSolicitationDelay());    // random delay
@@ -1057,7 +1058,7 @@ IPv6RouterSolicitation *IPv6NeighbourDiscoveryIoTorii::createAndSendRSPacket(Int
 
 void IPv6NeighbourDiscoveryIoTorii::initiateRouterDiscovery(cMessage *msg)
 {
-    EV_INFO << "Initiating Router Discovery" << endl;
+    IOTORII_EV_INFO(ND) << "Initiating Router Discovery" << endl;
     InterfaceEntry *ie = (InterfaceEntry *)msg->getContextPointer();
     delete msg;
     //RFC2461: Section 6.3.7
@@ -1095,13 +1096,13 @@ void IPv6NeighbourDiscoveryIoTorii::cancelRouterDiscovery(InterfaceEntry *ie)
     //Next we retrieve the rdEntry with the Interface Entry.
     RDEntry *rdEntry = fetchRDEntry(ie);
     if (rdEntry != nullptr) {
-        EV_DETAIL << "rdEntry is not nullptr, RD cancelled!" << endl;
+        IOTORII_EV_DETAIL(ND) << "rdEntry is not nullptr, RD cancelled!" << endl;
         cancelAndDelete(rdEntry->timeoutMsg);
         rdList.erase(rdEntry);
         delete rdEntry;
     }
     else
-        EV_DETAIL << "rdEntry is nullptr, not cancelling RD!" << endl;
+        IOTORII_EV_DETAIL(ND) << "rdEntry is nullptr, not cancelling RD!" << endl;
 }
 
 void IPv6NeighbourDiscoveryIoTorii::processRDTimeout(cMessage *msg)
@@ -1129,7 +1130,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRDTimeout(cMessage *msg)
            receive and process Router Advertisements messages in the event that routers
            appear on the link.*/
         bubble("Max number of RS messages sent");
-        EV_INFO << "No RA messages were received. Assume no routers are on-link";
+        IOTORII_EV_INFO(ND) << "No RA messages were received. Assume no routers are on-link";
         delete rdEntry;
         rdList.erase(rdEntry);
         delete msg;
@@ -1152,7 +1153,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRSPacket(IPv6RouterSolicitation *rs,
     //RFC 2461: Section 6.2.6
     //A host MUST silently discard any received Router Solicitation messages.
     if (ie->ipv6Data()->getAdvSendAdvertisements()) {
-        EV_INFO << "This is an advertising interface, processing RS\n";
+        IOTORII_EV_INFO(ND) << "This is an advertising interface, processing RS\n";
 
         if (validateRSPacket(rs, rsCtrlInfo) == false) {
             delete rsCtrlInfo;
@@ -1160,11 +1161,11 @@ void IPv6NeighbourDiscoveryIoTorii::processRSPacket(IPv6RouterSolicitation *rs,
             return;
         }
 
-        EV_INFO << "RS message validated\n";
+        IOTORII_EV_INFO(ND) << "RS message validated\n";
 
         //First we extract RS specific information from the received message
         MACAddress macAddr = rs->getSourceLinkLayerAddress();
-        EV_INFO << "MAC Address '" << macAddr << "' extracted\n";
+        IOTORII_EV_INFO(ND) << "MAC Address '" << macAddr << "' extracted\n";
         delete rsCtrlInfo;
         delete rs;
 
@@ -1214,7 +1215,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRSPacket(IPv6RouterSolicitation *rs,
            time given by the random value.*/
     }
     else {
-        EV_INFO << "This interface is a host, discarding RA message\n";
+        IOTORII_EV_INFO(ND) << "This interface is a host, discarding RA message\n";
         delete rsCtrlInfo;
         delete rs;
     }
@@ -1231,23 +1232,23 @@ bool IPv6NeighbourDiscoveryIoTorii::validateRSPacket(IPv6RouterSolicitation *rs,
        - The IP Hop Limit field has a value of 255, i.e., the packet
        could not possibly have been forwarded by a router.*/
     if (rsCtrlInfo->getHopLimit() != 255) {
-        EV_WARN << "Hop limit is not 255! RS validation failed!\n";
+        IOTORII_EV_WARN(ND) << "Hop limit is not 255! RS validation failed!\n";
         result = false;
     }
 
     //- ICMP Code is 0.
     if (rsCtrlInfo->getProtocol() != IP_PROT_IPv6_ICMP) {
-        EV_WARN << "ICMP Code is not 0! RS validation failed!\n";
+        IOTORII_EV_WARN(ND) << "ICMP Code is not 0! RS validation failed!\n";
         result = false;
     }
 
     //- If the IP source address is the unspecified address, there is no
     //source link-layer address option in the message.
     if (rsCtrlInfo->getSrcAddr().isUnspecified()) {
-        EV_WARN << "IP source address is unspecified\n";
+        IOTORII_EV_WARN(ND) << "IP source address is unspecified\n";
 
         if (rs->getSourceLinkLayerAddress().isUnspecified() == false) {
-            EV_WARN << " but source link layer address is provided. RS validation failed!\n";
+            IOTORII_EV_WARN(ND) << " but source link layer address is provided. RS validation failed!\n";
         }
     }
 
@@ -1256,7 +1257,7 @@ bool IPv6NeighbourDiscoveryIoTorii::validateRSPacket(IPv6RouterSolicitation *rs,
 
 IPv6RouterAdvertisement *IPv6NeighbourDiscoveryIoTorii::createAndSendRAPacket(const IPv6Address& destAddr, InterfaceEntry *ie)
 {
-    EV_INFO << "Create and send RA invoked!\n";
+    IOTORII_EV_INFO(ND) << "Create and send RA invoked!\n";
     //Must use link-local addr. See: RFC2461 Section 6.1.2
     IPv6Address sourceAddr = ie->ipv6Data()->getLinkLocalAddress();
 
@@ -1305,7 +1306,7 @@ IPv6RouterAdvertisement *IPv6NeighbourDiscoveryIoTorii::createAndSendRAPacket(co
 
         //Add all Advertising Prefixes to the RA
         int numAdvPrefixes = ie->ipv6Data()->getNumAdvPrefixes();
-        EV_DETAIL << "Number of Adv Prefixes: " << numAdvPrefixes << endl;
+        IOTORII_EV_DETAIL(ND) << "Number of Adv Prefixes: " << numAdvPrefixes << endl;
         ra->setPrefixInformationArraySize(numAdvPrefixes);
         for (int i = 0; i < numAdvPrefixes; i++) {
             IPv6InterfaceData::AdvPrefix advPrefix = ie->ipv6Data()->getAdvPrefix(i);
@@ -1314,13 +1315,13 @@ IPv6RouterAdvertisement *IPv6NeighbourDiscoveryIoTorii::createAndSendRAPacket(co
 #ifndef WITH_xMIPv6
             prefixInfo.setPrefix(advPrefix.prefix);
 #else /* WITH_xMIPv6 */
-            EV_DETAIL << "\n+=+=+=+= Appendign Prefix Info Option to RA +=+=+=+=\n";
-            EV_DETAIL << "Prefix Value: " << advPrefix.prefix << endl;
-            EV_DETAIL << "Prefix Length: " << advPrefix.prefixLength << endl;
-            EV_DETAIL << "L-Flag: " << advPrefix.advOnLinkFlag << endl;
-            EV_DETAIL << "A-Flag: " << advPrefix.advAutonomousFlag << endl;
-            EV_DETAIL << "R-Flag: " << advPrefix.advRtrAddr << endl;
-            EV_DETAIL << "Global Address from Prefix: " << advPrefix.rtrAddress << endl;
+            IOTORII_EV_DETAIL(ND) << "\n+=+=+=+= Appendign Prefix Info Option to RA +=+=+=+=\n";
+            IOTORII_EV_DETAIL(ND) << "Prefix Value: " << advPrefix.prefix << endl;
+            IOTORII_EV_DETAIL(ND) << "Prefix Length: " << advPrefix.prefixLength << endl;
+            IOTORII_EV_DETAIL(ND) << "L-Flag: " << advPrefix.advOnLinkFlag << endl;
+            IOTORII_EV_DETAIL(ND) << "A-Flag: " << advPrefix.advAutonomousFlag << endl;
+            IOTORII_EV_DETAIL(ND) << "R-Flag: " << advPrefix.advRtrAddr << endl;
+            IOTORII_EV_DETAIL(ND) << "Global Address from Prefix: " << advPrefix.rtrAddress << endl;
 
             if (rt6->isHomeAgent() && advPrefix.advRtrAddr == true)
                 prefixInfo.setPrefix(advPrefix.rtrAddress); //add the global-scope address of the HA's interface in the prefix option list of the RA message.
@@ -1366,7 +1367,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAPacket(IPv6RouterAdvertisement *ra,
     InterfaceEntry *ie = ift->getInterfaceById(raCtrlInfo->getInterfaceId());
 
     if (ie->ipv6Data()->getAdvSendAdvertisements()) {
-        EV_INFO << "Interface is an advertising interface, dropping RA message.\n";
+        IOTORII_EV_INFO(ND) << "Interface is an advertising interface, dropping RA message.\n";
         delete raCtrlInfo;
         delete ra;
         return;
@@ -1390,7 +1391,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAPacket(IPv6RouterAdvertisement *ra,
 #endif /* WITH_xMIPv6 */
 
         cancelRouterDiscovery(ie);    //Cancel router discovery if it is in progress.
-        EV_INFO << "Interface is a host, processing RA.\n";
+        IOTORII_EV_INFO(ND) << "Interface is a host, processing RA.\n";
 
         processRAForRouterUpdates(ra, raCtrlInfo);    //See RFC2461: Section 6.3.4
 
@@ -1414,7 +1415,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAPacket(IPv6RouterAdvertisement *ra,
                 // update 4.9.07 - CB
                 IPv6Address HoA = ie->ipv6Data()->getGlobalAddress();    //MN's home address
                 IPv6Address HA = raCtrlInfo->getSrcAddr().setPrefix(prefixInfo.getPrefix(), prefixInfo.getPrefixLength());
-                EV_DETAIL << "The HoA of MN is: " << HoA << ", MN's HA Address is: " << HA
+                IOTORII_EV_DETAIL(ND) << "The HoA of MN is: " << HoA << ", MN's HA Address is: " << HA
                           << " and the home prefix is " << prefixInfo.getPrefix() << endl;
                 ie->ipv6Data()->updateHomeNetworkInfo(HoA, HA, prefixInfo.getPrefix(), prefixInfo.getPrefixLength());    //populate the HoA of MN, the HA global scope address and the home network prefix
             }
@@ -1428,7 +1429,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAPacket(IPv6RouterAdvertisement *ra,
 void IPv6NeighbourDiscoveryIoTorii::processRAForRouterUpdates(IPv6RouterAdvertisement *ra,
         IPv6ControlInfo *raCtrlInfo)
 {
-    EV_INFO << "Processing RA for Router Updates\n";
+    IOTORII_EV_INFO(ND) << "Processing RA for Router Updates\n";
     //RFC2461: Section 6.3.4
     //Paragraphs 1 and 2 omitted.
 
@@ -1449,9 +1450,9 @@ void IPv6NeighbourDiscoveryIoTorii::processRAForRouterUpdates(IPv6RouterAdvertis
 #endif /* WITH_xMIPv6 */
 
     if (neighbour == nullptr) {
-        EV_INFO << "Neighbour Cache Entry does not contain RA's source address\n";
+        IOTORII_EV_INFO(ND) << "Neighbour Cache Entry does not contain RA's source address\n";
         if (ra->getRouterLifetime() != 0) {
-            EV_INFO << "RA's router lifetime is non-zero, creating an entry in the "
+            IOTORII_EV_INFO(ND) << "RA's router lifetime is non-zero, creating an entry in the "
                     << "Host's default router list with lifetime=" << ra->getRouterLifetime() << "\n";
 
 #ifdef WITH_xMIPv6
@@ -1472,7 +1473,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAForRouterUpdates(IPv6RouterAdvertis
             rt6->addDefaultRoute(raSrcAddr, ifID, simTime() + ra->getRouterLifetime());
         }
         else {
-            EV_INFO << "Router Lifetime is 0, adding NON-default router.\n";
+            IOTORII_EV_INFO(ND) << "Router Lifetime is 0, adding NON-default router.\n";
             //WEI-The router is advertising itself, BUT not as a default router.
             if (ra->getSourceLinkLayerAddress().isUnspecified())
                 neighbour = neighbourCache.addNeighbour(raSrcAddr, ifID);
@@ -1502,7 +1503,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAForRouterUpdates(IPv6RouterAdvertis
            and the received Router Lifetime value is zero, immediately time-out the
            entry as specified in Section 6.3.5.*/
         if (ra->getRouterLifetime() == 0) {
-            EV_INFO << "RA's router lifetime is ZERO. Timing-out entry.\n";
+            IOTORII_EV_INFO(ND) << "RA's router lifetime is ZERO. Timing-out entry.\n";
             timeoutDefaultRouter(raSrcAddr, ifID);
         }
     }
@@ -1512,7 +1513,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAForRouterUpdates(IPv6RouterAdvertis
     //If the received Cur Hop Limit value is non-zero the host SHOULD set
     //its CurHopLimit variable to the received value.
     if (ra->getCurHopLimit() != 0) {
-        EV_INFO << "RA's Cur Hop Limit is non-zero. Setting host's Cur Hop Limit to "
+        IOTORII_EV_INFO(ND) << "RA's Cur Hop Limit is non-zero. Setting host's Cur Hop Limit to "
                 << "received value.\n";
         ie->ipv6Data()->setCurHopLimit(ra->getCurHopLimit());
     }
@@ -1520,10 +1521,10 @@ void IPv6NeighbourDiscoveryIoTorii::processRAForRouterUpdates(IPv6RouterAdvertis
     //If the received Reachable Time value is non-zero the host SHOULD set its
     //BaseReachableTime variable to the received value.
     if (ra->getReachableTime() != 0) {
-        EV_INFO << "RA's reachable time is non-zero ";
+        IOTORII_EV_INFO(ND) << "RA's reachable time is non-zero ";
 
         if (ra->getReachableTime() != SIMTIME_DBL(ie->ipv6Data()->getReachableTime())) {
-            EV_INFO << " and RA's and Host's reachable time differ, \nsetting host's base"
+            IOTORII_EV_INFO(ND) << " and RA's and Host's reachable time differ, \nsetting host's base"
                     << " reachable time to received value.\n";
             ie->ipv6Data()->setBaseReachableTime(ra->getReachableTime());
             //If the new value differs from the previous value, the host SHOULD
@@ -1531,13 +1532,13 @@ void IPv6NeighbourDiscoveryIoTorii::processRAForRouterUpdates(IPv6RouterAdvertis
             ie->ipv6Data()->setReachableTime(ie->ipv6Data()->generateReachableTime());
         }
 
-        EV_INFO << endl;
+        IOTORII_EV_INFO(ND) << endl;
     }
 
     //The RetransTimer variable SHOULD be copied from the Retrans Timer field,
     //if the received value is non-zero.
     if (ra->getRetransTimer() != 0) {
-        EV_INFO << "RA's retrans timer is non-zero, copying retrans timer variable.\n";
+        IOTORII_EV_INFO(ND) << "RA's retrans timer is non-zero, copying retrans timer variable.\n";
         ie->ipv6Data()->setRetransTimer(ra->getRetransTimer());
     }
 
@@ -1576,7 +1577,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAPrefixInfo(IPv6RouterAdvertisement
             break; //skip to next prefix option
 
         //with the on-link flag set, a host does the following:
-        EV_INFO << "Fetching Prefix Information:" << i + 1 << " of "
+        IOTORII_EV_INFO(ND) << "Fetching Prefix Information:" << i + 1 << " of "
                 << ra->getPrefixInformationArraySize() << endl;
         uint prefixLength = prefixInfo.getPrefixLength();
         simtime_t validLifetime = prefixInfo.getValidLifetime();
@@ -1586,7 +1587,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAPrefixInfo(IPv6RouterAdvertisement
         //- If the prefix is the link-local prefix, silently ignore the Prefix
         //Information option.
         if (prefix.isLinkLocal()) {
-            EV_INFO << "Prefix is link-local, ignoring prefix.\n";
+            IOTORII_EV_INFO(ND) << "Prefix is link-local, ignoring prefix.\n";
             return;
         }
 
@@ -1607,7 +1608,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAPrefixInfo(IPv6RouterAdvertisement
             /* If the new Lifetime value is zero, time-out the prefix immediately
                (see Section 6.3.5).*/
             if (validLifetime == 0) {
-                EV_INFO << "Prefix Info's valid lifetime is 0, time-out prefix\n";
+                IOTORII_EV_INFO(ND) << "Prefix Info's valid lifetime is 0, time-out prefix\n";
                 rt6->deleteOnLinkPrefix(prefix, prefixLength);
                 return;
             }
@@ -1634,7 +1635,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAPrefixInfo(IPv6RouterAdvertisement
 #ifndef WITH_xMIPv6
 void IPv6NeighbourDiscoveryIoTorii::processRAPrefixInfoForAddrAutoConf(IPv6NDPrefixInformation& prefixInfo, InterfaceEntry *ie)
 {
-    EV_INFO << "Processing Prefix Info for address auto-configuration.\n";
+    IOTORII_EV_INFO(ND) << "Processing Prefix Info for address auto-configuration.\n";
     IPv6Address prefix = prefixInfo.getPrefix();
     uint prefixLength = prefixInfo.getPrefixLength();
     simtime_t preferredLifetime = prefixInfo.getPreferredLifetime();
@@ -1646,7 +1647,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAPrefixInfoForAddrAutoConf(IPv6NDPre
     //b) If the prefix is the link-local prefix, silently ignore the Prefix
     //Information option.
     if (prefixInfo.getPrefix().isLinkLocal() == true) {
-        EV_INFO << "Prefix is link-local, ignore Prefix Information Option\n";
+        IOTORII_EV_INFO(ND) << "Prefix is link-local, ignore Prefix Information Option\n";
         return;
     }
 
@@ -1654,7 +1655,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAPrefixInfoForAddrAutoConf(IPv6NDPre
     //ignore the Prefix Information option. A node MAY wish to log a system
     //management error in this case.
     if (preferredLifetime > validLifetime) {
-        EV_INFO << "Preferred lifetime is greater than valid lifetime, ignore Prefix Information\n";
+        IOTORII_EV_INFO(ND) << "Preferred lifetime is greater than valid lifetime, ignore Prefix Information\n";
         return;
     }
 
@@ -1674,7 +1675,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAPrefixInfoForAddrAutoConf(IPv6NDPre
         IPv6Address newAddr = linkLocalAddress.setPrefix(prefix, prefixLength);
         //TODO: for now we leave the newly formed address as not tentative,
         //according to Greg, we have to always perform DAD for a newly formed address.
-        EV_INFO << "Assigning new address to: " << ie->getName() << endl;
+        IOTORII_EV_INFO(ND) << "Assigning new address to: " << ie->getName() << endl;
         ie->ipv6Data()->assignAddress(newAddr, false, simTime() + validLifetime,
                 simTime() + preferredLifetime);
     }
@@ -1725,16 +1726,16 @@ void IPv6NeighbourDiscoveryIoTorii::createRATimer(InterfaceEntry *ie)
     // update 23.10.07 - CB
 
     if (canServeWirelessNodes(ie)) {
-        EV_INFO << "This Interface is connected to a WLAN AP, hence using MIPv6 Default Values" << endl;
+        IOTORII_EV_INFO(ND) << "This Interface is connected to a WLAN AP, hence using MIPv6 Default Values" << endl;
         simtime_t minRAInterval = par("minIntervalBetweenRAs");    //reading from the omnetpp.ini (ZY 23.07.09)
         simtime_t maxRAInterval = par("maxIntervalBetweenRAs");    //reading from the omnetpp.ini (ZY 23.07.09
         ie->ipv6Data()->setMinRtrAdvInterval(minRAInterval);
         ie->ipv6Data()->setMaxRtrAdvInterval(maxRAInterval);
     }
     else {
-        EV_INFO << "This Interface is not connected to a WLAN AP, hence using default values" << endl;
+        IOTORII_EV_INFO(ND) << "This Interface is not connected to a WLAN AP, hence using default values" << endl;
         //interval = uniform( ie->ipv6()->minRtrAdvInterval(), ie->ipv6()->maxRtrAdvInterval() );
-        //EV<<"\nThe random calculated RA_ND interval is: "<< interval<<" seconds\n";
+        //IOTORII_EV(ND)<<"\nThe random calculated RA_ND interval is: "<< interval<<" seconds\n";
     }
     // end CB
 #endif /* WITH_xMIPv6 */
@@ -1745,8 +1746,8 @@ void IPv6NeighbourDiscoveryIoTorii::createRATimer(InterfaceEntry *ie)
     simtime_t nextScheduledTime = simTime() + interval;
     advIfEntry->nextScheduledRATime = nextScheduledTime;
     advIfList.insert(advIfEntry);
-    EV_DETAIL << "Interval: " << interval << endl;
-    EV_DETAIL << "Next scheduled time: " << nextScheduledTime << endl;
+    IOTORII_EV_DETAIL(ND) << "Interval: " << interval << endl;
+    IOTORII_EV_DETAIL(ND) << "Next scheduled time: " << nextScheduledTime << endl;
     //now we schedule the msg for whatever time that was derived
     scheduleAt(nextScheduledTime, msg);
 }
@@ -1762,7 +1763,7 @@ void IPv6NeighbourDiscoveryIoTorii::resetRATimer(InterfaceEntry *ie)
         //Find the timer that matches the given Interface Entry.
         if (msgIE->outputPort() == ie->outputPort())
         {
-            EV << "Resetting RA timer for port: " << ie->outputPort();
+            IOTORII_EV(ND) << "Resetting RA timer for port: " << ie->outputPort();
             cancelEvent(msg);//Cancel the next scheduled msg.
             simtime_t interval
                 = uniform(ie->ipv6Data()->getMinRtrAdvInterval(),ie->ipv6Data()->getMaxRtrAdvInterval());
@@ -1790,34 +1791,34 @@ void IPv6NeighbourDiscoveryIoTorii::sendPeriodicRA(cMessage *msg)
     simtime_t interval;
 
 #ifdef WITH_xMIPv6
-    EV_DEBUG << "\n+=+=+= MIPv6 Feature: " << rt6->hasMIPv6Support() << " +=+=+=\n";
+    IOTORII_EV_DEBUG(ND) << "\n+=+=+= MIPv6 Feature: " << rt6->hasMIPv6Support() << " +=+=+=\n";
 #endif /* WITH_xMIPv6 */
 
     interval = uniform(ie->ipv6Data()->getMinRtrAdvInterval(), ie->ipv6Data()->getMaxRtrAdvInterval());
 
 #ifdef WITH_xMIPv6
-    EV_DETAIL << "\n +=+=+= The random calculated interval is: " << interval << " +=+=+=\n";
+    IOTORII_EV_DETAIL(ND) << "\n +=+=+= The random calculated interval is: " << interval << " +=+=+=\n";
 #endif /* WITH_xMIPv6 */
 
     nextScheduledTime = simTime() + interval;
 
     /*For the first few advertisements (up to MAX_INITIAL_RTR_ADVERTISEMENTS)
        sent from an interface when it becomes an advertising interface,*/
-    EV_DETAIL << "Num RA sent is: " << advIfEntry->numRASent << endl;
-    EV_DETAIL << "maxInitialRtrAdvertisements is: " << ie->ipv6Data()->_getMaxInitialRtrAdvertisements() << endl;
+    IOTORII_EV_DETAIL(ND) << "Num RA sent is: " << advIfEntry->numRASent << endl;
+    IOTORII_EV_DETAIL(ND) << "maxInitialRtrAdvertisements is: " << ie->ipv6Data()->_getMaxInitialRtrAdvertisements() << endl;
 
     if (advIfEntry->numRASent <= ie->ipv6Data()->_getMaxInitialRtrAdvertisements()) {
         if (interval > ie->ipv6Data()->_getMaxInitialRtrAdvertInterval()) {
             //if the randomly chosen interval is greater than MAX_INITIAL_RTR_ADVERT_INTERVAL,
             //the timer SHOULD be set to MAX_INITIAL_RTR_ADVERT_INTERVAL instead.
             nextScheduledTime = simTime() + ie->ipv6Data()->_getMaxInitialRtrAdvertInterval();
-            EV_INFO << "Sending initial RA but interval is too long. Using default value." << endl;
+            IOTORII_EV_INFO(ND) << "Sending initial RA but interval is too long. Using default value." << endl;
         }
         else
-            EV_INFO << "Sending initial RA. Using randomly generated interval." << endl;
+            IOTORII_EV_INFO(ND) << "Sending initial RA. Using randomly generated interval." << endl;
     }
 
-    EV_DETAIL << "Next scheduled time: " << nextScheduledTime << endl;
+    IOTORII_EV_DETAIL(ND) << "Next scheduled time: " << nextScheduledTime << endl;
     advIfEntry->nextScheduledRATime = nextScheduledTime;
     ASSERT(nextScheduledTime > simTime());
     scheduleAt(nextScheduledTime, msg);
@@ -1825,10 +1826,10 @@ void IPv6NeighbourDiscoveryIoTorii::sendPeriodicRA(cMessage *msg)
 
 void IPv6NeighbourDiscoveryIoTorii::sendSolicitedRA(cMessage *msg)
 {
-    EV_INFO << "Send Solicited RA invoked!\n";
+    IOTORII_EV_INFO(ND) << "Send Solicited RA invoked!\n";
     InterfaceEntry *ie = (InterfaceEntry *)msg->getContextPointer();
     IPv6Address destAddr = IPv6Address("FF02::1");
-    EV_DETAIL << "Testing condition!\n";
+    IOTORII_EV_DETAIL(ND) << "Testing condition!\n";
     createAndSendRAPacket(destAddr, ie);
     delete msg;
 }
@@ -1848,20 +1849,20 @@ bool IPv6NeighbourDiscoveryIoTorii::validateRAPacket(IPv6RouterAdvertisement *ra
     //  and Redirect messages so that hosts can uniquely identify
     //  routers.
     if (raCtrlInfo->getSrcAddr().isLinkLocal() == false) {
-        EV_WARN << "RA source address is not link-local. RA validation failed!\n";
+        IOTORII_EV_WARN(ND) << "RA source address is not link-local. RA validation failed!\n";
         result = false;
     }
 
     //- The IP Hop Limit field has a value of 255, i.e., the packet
     //  could not possibly have been forwarded by a router.
     if (raCtrlInfo->getHopLimit() != 255) {
-        EV_WARN << "Hop limit is not 255! RA validation failed!\n";
+        IOTORII_EV_WARN(ND) << "Hop limit is not 255! RA validation failed!\n";
         result = false;
     }
 
     //- ICMP Code is 0.
     if (raCtrlInfo->getProtocol() != IP_PROT_IPv6_ICMP) {
-        EV_WARN << "ICMP Code is not 0! RA validation failed!\n";
+        IOTORII_EV_WARN(ND) << "ICMP Code is not 0! RA validation failed!\n";
         result = false;
     }
 
@@ -1869,7 +1870,7 @@ bool IPv6NeighbourDiscoveryIoTorii::validateRAPacket(IPv6RouterAdvertisement *ra
     // - All included options have a length that is greater than zero.
     // CB
     if (ra->getPrefixInformationArraySize() == 0) {
-        EV_WARN << "No prefix information available! RA validation failed\n";
+        IOTORII_EV_WARN(ND) << "No prefix information available! RA validation failed\n";
         result = false;
     }
 #endif /* WITH_xMIPv6 */
@@ -1880,7 +1881,7 @@ bool IPv6NeighbourDiscoveryIoTorii::validateRAPacket(IPv6RouterAdvertisement *ra
 IPv6NeighbourSolicitation *IPv6NeighbourDiscoveryIoTorii::createAndSendNSPacket(const IPv6Address& nsTargetAddr, const IPv6Address& dgDestAddr,
         const IPv6Address& dgSrcAddr, InterfaceEntry *ie)
 {
-    EV << "->IPv6NeighbourDiscoveryIoTorii::createAndSendNSPacket()" << endl;  //EXTRA
+    IOTORII_EV(ND) << "->IPv6NeighbourDiscoveryIoTorii::createAndSendNSPacket()" << endl;  //EXTRA
 #ifdef WITH_xMIPv6
     Enter_Method_Silent();
 #endif /* WITH_xMIPv6 */
@@ -1890,12 +1891,12 @@ IPv6NeighbourSolicitation *IPv6NeighbourDiscoveryIoTorii::createAndSendNSPacket(
     //Construct a Neighbour Solicitation message
     IPv6NeighbourSolicitation *ns = new IPv6NeighbourSolicitation("NSpacket");
     ns->setType(ICMPv6_NEIGHBOUR_SOL);
-    EV << "NSpacket: Type is " << ICMPv6_NEIGHBOUR_SOL ;  //EXTRA
+    IOTORII_EV(ND) << "NSpacket: Type is " << ICMPv6_NEIGHBOUR_SOL ;  //EXTRA
 
     //Neighbour Solicitation Specific Information
     ns->setTargetAddress(nsTargetAddr);
     ns->setByteLength(ICMPv6_HEADER_BYTES + IPv6_ADDRESS_SIZE);      // RFC 2461, Section 4.3.
-    EV << " , TargetAddress is " << nsTargetAddr << ", ByteLength is " << ICMPv6_HEADER_BYTES + IPv6_ADDRESS_SIZE << endl;  //EXTRA
+    IOTORII_EV(ND) << " , TargetAddress is " << nsTargetAddr << ", ByteLength is " << ICMPv6_HEADER_BYTES + IPv6_ADDRESS_SIZE << endl;  //EXTRA
 
 
     /*If the solicitation is being sent to a solicited-node multicast
@@ -1909,7 +1910,7 @@ IPv6NeighbourSolicitation *IPv6NeighbourDiscoveryIoTorii::createAndSendNSPacket(
     }
 
     sendPacketToIPv6Module(ns, dgDestAddr, dgSrcAddr, ie->getInterfaceId());
-    EV << "<-IPv6NeighbourDiscoveryIoTorii::createAndSendNSPacket()" << endl;  //EXTRA
+    IOTORII_EV(ND) << "<-IPv6NeighbourDiscoveryIoTorii::createAndSendNSPacket()" << endl;  //EXTRA
 
     return ns;
 }
@@ -1939,12 +1940,12 @@ void IPv6NeighbourDiscoveryIoTorii::processNSPacket(IPv6NeighbourSolicitation *n
     if (ie->ipv6Data()->isTentativeAddress(nsTargetAddr)) {
         //If the Target Address is tentative, the Neighbor Solicitation should
         //be processed as described in [ADDRCONF].
-        EV_INFO << "Process NS for Tentative target address.\n";
+        IOTORII_EV_INFO(ND) << "Process NS for Tentative target address.\n";
         processNSForTentativeAddress(ns, nsCtrlInfo);
     }
     else {
         //Otherwise, the following description applies.
-        EV_INFO << "Process NS for Non-Tentative target address.\n";
+        IOTORII_EV_INFO(ND) << "Process NS for Non-Tentative target address.\n";
         processNSForNonTentativeAddress(ns, nsCtrlInfo, ie);
     }
 
@@ -1963,32 +1964,32 @@ bool IPv6NeighbourDiscoveryIoTorii::validateNSPacket(IPv6NeighbourSolicitation *
     //- The IP Hop Limit field has a value of 255, i.e., the packet
     //could not possibly have been forwarded by a router.
     if (nsCtrlInfo->getHopLimit() != 255) {
-        EV_WARN << "Hop limit is not 255! NS validation failed!\n";
+        IOTORII_EV_WARN(ND) << "Hop limit is not 255! NS validation failed!\n";
         result = false;
     }
 
     //- Target Address is not a multicast address.
     if (ns->getTargetAddress().isMulticast() == true) {
-        EV_WARN << "Target address is a multicast address! NS validation failed!\n";
+        IOTORII_EV_WARN(ND) << "Target address is a multicast address! NS validation failed!\n";
         result = false;
     }
 
     //- If the IP source address is the unspecified address,
     if (nsCtrlInfo->getSrcAddr().isUnspecified()) {
-        EV_WARN << "Source Address is unspecified\n";
+        IOTORII_EV_WARN(ND) << "Source Address is unspecified\n";
 
         //the IP destination address is a solicited-node multicast address.
         if (nsCtrlInfo->getDestAddr().matches(IPv6Address::SOLICITED_NODE_PREFIX, 104) == false) {
-            EV_WARN << " but IP dest address is not a solicited-node multicast address! NS validation failed!\n";
+            IOTORII_EV_WARN(ND) << " but IP dest address is not a solicited-node multicast address! NS validation failed!\n";
             result = false;
         }
         //there is no source link-layer address option in the message.
         else if (ns->getSourceLinkLayerAddress().isUnspecified() == false) {
-            EV_WARN << " but Source link-layer address is not empty! NS validation failed!\n";
+            IOTORII_EV_WARN(ND) << " but Source link-layer address is not empty! NS validation failed!\n";
             result = false;
         }
         else
-            EV_WARN << "NS Validation Passed\n";
+            IOTORII_EV_WARN(ND) << "NS Validation Passed\n";
     }
 
     return result;
@@ -2005,20 +2006,20 @@ void IPv6NeighbourDiscoveryIoTorii::processNSForTentativeAddress(IPv6NeighbourSo
     //solicitation is processed as described in RFC2462:section 5.4.3
 
     if (nsSrcAddr.isUnspecified()) {
-        EV_INFO << "Source Address is UNSPECIFIED. Sender is performing DAD\n";
+        IOTORII_EV_INFO(ND) << "Source Address is UNSPECIFIED. Sender is performing DAD\n";
 
         //Sender performing Duplicate Address Detection
         if (rt6->isLocalAddress(nsSrcAddr)) // FIXME: isLocalAddress(UNSPECIFIED) is always false!!! Must write another check for detecting source is myself/foreign node!!!
-            EV_INFO << "NS comes from myself. Ignoring NS\n";
+            IOTORII_EV_INFO(ND) << "NS comes from myself. Ignoring NS\n";
         else {
-            EV_INFO << "NS comes from another node. Address is duplicate!\n";
+            IOTORII_EV_INFO(ND) << "NS comes from another node. Address is duplicate!\n";
             throw cRuntimeError("Duplicate Address Detected! Manual Attention Required!");
         }
     }
     else if (nsSrcAddr.isUnicast()) {
         //Sender performing address resolution
-        EV_INFO << "Sender is performing Address Resolution\n";
-        EV_INFO << "Target Address is tentative. Ignoring NS.\n";
+        IOTORII_EV_INFO(ND) << "Sender is performing Address Resolution\n";
+        IOTORII_EV_INFO(ND) << "Target Address is tentative. Ignoring NS.\n";
     }
 }
 
@@ -2031,7 +2032,7 @@ void IPv6NeighbourDiscoveryIoTorii::processNSForNonTentativeAddress(IPv6Neighbou
     //target addr is not tentative addr
     //solicitation processed as described in RFC2461:section 7.2.3
     if (nsCtrlInfo->getSrcAddr().isUnspecified()) {
-        EV_INFO << "Address is duplicate! Inform Sender of duplicate address!\n";
+        IOTORII_EV_INFO(ND) << "Address is duplicate! Inform Sender of duplicate address!\n";
         sendSolicitedNA(ns, nsCtrlInfo, ie);
     }
     else {
@@ -2042,7 +2043,7 @@ void IPv6NeighbourDiscoveryIoTorii::processNSForNonTentativeAddress(IPv6Neighbou
 void IPv6NeighbourDiscoveryIoTorii::processNSWithSpecifiedSrcAddr(IPv6NeighbourSolicitation *ns,
         IPv6ControlInfo *nsCtrlInfo, InterfaceEntry *ie)
 {
-    EV << "->IPv6NeighbourDiscoveryIoTorii::processNSWithSpecifiedSrcAddr()" << endl; //EXTRA
+    IOTORII_EV(ND) << "->IPv6NeighbourDiscoveryIoTorii::processNSWithSpecifiedSrcAddr()" << endl; //EXTRA
     //RFC 2461, Section 7.2.3
     /*If the Source Address is not the unspecified address and, on link layers
        that have addresses, the solicitation includes a Source Link-Layer Address
@@ -2060,7 +2061,7 @@ void IPv6NeighbourDiscoveryIoTorii::processNSWithSpecifiedSrcAddr(IPv6NeighbourS
     if (entry == nullptr) {
         /*If an entry does not already exist, the node SHOULD create a new one
            and set its reachability state to STALE as specified in Section 7.3.3.*/
-        EV_INFO << "Neighbour Entry not found. Create a Neighbour Cache Entry.\n";
+        IOTORII_EV_INFO(ND) << "Neighbour Entry not found. Create a Neighbour Cache Entry.\n";
         neighbourCache.addNeighbour(nsCtrlInfo->getSrcAddr(), ifID, nsMacAddr);
     }
     else {
@@ -2077,13 +2078,13 @@ void IPv6NeighbourDiscoveryIoTorii::processNSWithSpecifiedSrcAddr(IPv6NeighbourS
     /*After any updates to the Neighbor Cache, the node sends a Neighbor
        Advertisement response as described in the next section.*/
     sendSolicitedNA(ns, nsCtrlInfo, ie);
-    EV << "<-IPv6NeighbourDiscoveryIoTorii::processNSWithSpecifiedSrcAddr()" << endl; //EXTRA
+    IOTORII_EV(ND) << "<-IPv6NeighbourDiscoveryIoTorii::processNSWithSpecifiedSrcAddr()" << endl; //EXTRA
 }
 
 void IPv6NeighbourDiscoveryIoTorii::sendSolicitedNA(IPv6NeighbourSolicitation *ns,
         IPv6ControlInfo *nsCtrlInfo, InterfaceEntry *ie)
 {
-    EV << "->IPv6NeighbourDiscoveryIoTorii::sendSolicitedNA()" << endl; //EXTRA
+    IOTORII_EV(ND) << "->IPv6NeighbourDiscoveryIoTorii::sendSolicitedNA()" << endl; //EXTRA
 
     IPv6NeighbourAdvertisement *na = new IPv6NeighbourAdvertisement("NApacket");
     na->setByteLength(ICMPv6_HEADER_BYTES + IPv6_ADDRESS_SIZE);      // FIXME set correct length
@@ -2094,7 +2095,7 @@ void IPv6NeighbourDiscoveryIoTorii::sendSolicitedNA(IPv6NeighbourSolicitation *n
        Target Address of the advertisement is copied from the Target Address
        of the solicitation.*/
     na->setTargetAddress(ns->getTargetAddress());
-    EV << "NApacket:  TargetAddress is " << ns->getTargetAddress();  //EXTRA
+    IOTORII_EV(ND) << "NApacket:  TargetAddress is " << ns->getTargetAddress();  //EXTRA
 
     /*If the solicitation's IP Destination Address is not a multicast address,
        the Target Link-Layer Address option MAY be omitted; the neighboring node's
@@ -2106,12 +2107,12 @@ void IPv6NeighbourDiscoveryIoTorii::sendSolicitedNA(IPv6NeighbourSolicitation *n
 
 
     na->addByteLength(IPv6ND_LINK_LAYER_ADDRESS_OPTION_LENGTH);
-    EV << " , ByteLength is " << IPv6ND_LINK_LAYER_ADDRESS_OPTION_LENGTH;  //EXTRA
+    IOTORII_EV(ND) << " , ByteLength is " << IPv6ND_LINK_LAYER_ADDRESS_OPTION_LENGTH;  //EXTRA
 
     /*Furthermore, if the node is a router, it MUST set the Router flag to one;
        otherwise it MUST set the flag to zero.*/
     na->setRouterFlag(rt6->isRouter());
-    EV << " , RouterFlag is " << rt6->isRouter() << endl;  //EXTRA
+    IOTORII_EV(ND) << " , RouterFlag is " << rt6->isRouter() << endl;  //EXTRA
 
 
     /*If the (NS)Target Address is either an anycast address or a unicast
@@ -2139,7 +2140,7 @@ void IPv6NeighbourDiscoveryIoTorii::sendSolicitedNA(IPv6NeighbourSolicitation *n
            to the all-nodes address.*/
         na->setSolicitedFlag(false);
         naDestAddr = IPv6Address::ALL_NODES_2;
-        EV << "nsCtrlInfo->getSrcAddr(" << nsCtrlInfo->getSrcAddr() << ")is unspecified, then SolicitedFlag is false and naDestAddr is " << IPv6Address::ALL_NODES_2 << endl;  //EXTRA
+        IOTORII_EV(ND) << "nsCtrlInfo->getSrcAddr(" << nsCtrlInfo->getSrcAddr() << ")is unspecified, then SolicitedFlag is false and naDestAddr is " << IPv6Address::ALL_NODES_2 << endl;  //EXTRA
 
     }
     else {
@@ -2147,7 +2148,7 @@ void IPv6NeighbourDiscoveryIoTorii::sendSolicitedNA(IPv6NeighbourSolicitation *n
            the advertisement to the Source Address of the solicitation.*/
         na->setSolicitedFlag(true);
         naDestAddr = nsCtrlInfo->getSrcAddr();
-        EV << "nsCtrlInfo->getSrcAddr(" << nsCtrlInfo->getSrcAddr() << ")is not unspecified, then SolicitedFlag is true and naDestAddr is " << nsCtrlInfo->getSrcAddr() << endl;  //EXTRA
+        IOTORII_EV(ND) << "nsCtrlInfo->getSrcAddr(" << nsCtrlInfo->getSrcAddr() << ")is not unspecified, then SolicitedFlag is true and naDestAddr is " << nsCtrlInfo->getSrcAddr() << endl;  //EXTRA
     }
 
     /*If the Target Address is an anycast address the sender SHOULD delay sending
@@ -2170,7 +2171,7 @@ void IPv6NeighbourDiscoveryIoTorii::sendSolicitedNA(IPv6NeighbourSolicitation *n
     //done we should check the destinations of the list of queued packets and send
     //off the respective ones.
     IPv6Address myIPv6Addr = ie->ipv6Data()->getPreferredAddress();
-    EV << "NApacket has been prepared to send to IPv6" << endl;  //EXTRA
+    IOTORII_EV(ND) << "NApacket has been prepared to send to IPv6" << endl;  //EXTRA
     //EXTRA BEGIN
     //sendPacketToIPv6Module(na, naDestAddr, myIPv6Addr, ie->getInterfaceId());
 
@@ -2190,7 +2191,7 @@ void IPv6NeighbourDiscoveryIoTorii::sendSolicitedNA(IPv6NeighbourSolicitation *n
     else
         sendPacketToIPv6Module(na, naDestAddr, myIPv6Addr, ie->getInterfaceId());
     //EXTRA END
-    EV << "<-IPv6NeighbourDiscoveryIoTorii::sendSolicitedNA()" << endl; //EXTRA
+    IOTORII_EV(ND) << "<-IPv6NeighbourDiscoveryIoTorii::sendSolicitedNA()" << endl; //EXTRA
 }
 
 void IPv6NeighbourDiscoveryIoTorii::sendUnsolicitedNA(InterfaceEntry *ie)
@@ -2299,15 +2300,15 @@ void IPv6NeighbourDiscoveryIoTorii::processNAPacket(IPv6NeighbourAdvertisement *
     Neighbour *neighbourEntry = neighbourCache.lookup(naTargetAddr, ie->getInterfaceId());
 
     if (neighbourEntry == nullptr) {
-        EV_INFO << "NA received. Target Address not found in Neighbour Cache\n";
-        EV_INFO << "Dropping NA packet.\n";
+        IOTORII_EV_INFO(ND) << "NA received. Target Address not found in Neighbour Cache\n";
+        IOTORII_EV_INFO(ND) << "Dropping NA packet.\n";
         delete naCtrlInfo;
         delete na;
         return;
     }
 
     //Target Address has entry in Neighbour Cache
-    EV_INFO << "NA received. Target Address found in Neighbour Cache\n";
+    IOTORII_EV_INFO(ND) << "NA received. Target Address found in Neighbour Cache\n";
 
     if (neighbourEntry->reachabilityState == IPv6NeighbourCacheIoTorii::INCOMPLETE)
         processNAForIncompleteNCEState(na, neighbourEntry);
@@ -2330,13 +2331,13 @@ bool IPv6NeighbourDiscoveryIoTorii::validateNAPacket(IPv6NeighbourAdvertisement
     //- The IP Hop Limit field has a value of 255, i.e., the packet
     //  could not possibly have been forwarded by a router.
     if (naCtrlInfo->getHopLimit() != 255) {
-        EV_WARN << "Hop Limit is not 255! NA validation failed!\n";
+        IOTORII_EV_WARN(ND) << "Hop Limit is not 255! NA validation failed!\n";
         result = false;
     }
 
     //- Target Address is not a multicast address.
     if (na->getTargetAddress().isMulticast() == true) {
-        EV_WARN << "Target Address is a multicast address! NA validation failed!\n";
+        IOTORII_EV_WARN(ND) << "Target Address is a multicast address! NA validation failed!\n";
         result = false;
     }
 
@@ -2344,7 +2345,7 @@ bool IPv6NeighbourDiscoveryIoTorii::validateNAPacket(IPv6NeighbourAdvertisement
     //  is zero.
     if (naCtrlInfo->getDestAddr().isMulticast()) {
         if (na->getSolicitedFlag() == true) {
-            EV_WARN << "Dest Address is multicast address but solicted flag is 0!\n";
+            IOTORII_EV_WARN(ND) << "Dest Address is multicast address but solicted flag is 0!\n";
             result = false;
         }
     }
@@ -2371,20 +2372,20 @@ void IPv6NeighbourDiscoveryIoTorii::processNAForIncompleteNCEState(IPv6Neighbour
         /*If the link layer has addresses and no Target Link-Layer address option
            is included, the receiving node SHOULD silently discard the received
            advertisement.*/
-        EV_INFO << "No MAC Address specified in NA. Ignoring NA\n";
+        IOTORII_EV_INFO(ND) << "No MAC Address specified in NA. Ignoring NA\n";
         return;
     }
     else {
         //Otherwise, the receiving node performs the following steps:
         //- It records the link-layer address in the neighbour Cache entry.
-        EV_INFO << "ND is updating Neighbour Cache Entry.\n";
+        IOTORII_EV_INFO(ND) << "ND is updating Neighbour Cache Entry.\n";
         nce->macAddress = naMacAddr;
 
         //- If the advertisement's Solicited flag is set, the state of the
         //  entry is set to REACHABLE, otherwise it is set to STALE.
         if (naSolicitedFlag == true) {
             nce->reachabilityState = IPv6NeighbourCacheIoTorii::REACHABLE;
-            EV_INFO << "Reachability confirmed through successful Addr Resolution.\n";
+            IOTORII_EV_INFO(ND) << "Reachability confirmed through successful Addr Resolution.\n";
             nce->reachabilityExpires = simTime() + ie->ipv6Data()->_getReachableTime();
         }
         else
@@ -2421,26 +2422,26 @@ void IPv6NeighbourDiscoveryIoTorii::processNAForOtherNCEStates(IPv6NeighbourAdve
     if (naOverrideFlag == false && !(naMacAddr.equals(nce->macAddress))
         && !(naMacAddr.isUnspecified()))
     {
-        EV_INFO << "NA override is FALSE and NA MAC addr is different.\n";
+        IOTORII_EV_INFO(ND) << "NA override is FALSE and NA MAC addr is different.\n";
 
         //I. If the Override flag is clear and the supplied link-layer address
         //   differs from that in the cache, then one of two actions takes place:
         //(Note: An unspecified MAC should not be compared with the NCE's mac!)
         //a. If the state of the entry is REACHABLE,
         if (nce->reachabilityState == IPv6NeighbourCacheIoTorii::REACHABLE) {
-            EV_INFO << "NA mac is different. Change NCE state from REACHABLE to STALE\n";
+            IOTORII_EV_INFO(ND) << "NA mac is different. Change NCE state from REACHABLE to STALE\n";
             //set it to STALE, but do not update the entry in any other way.
             nce->reachabilityState = IPv6NeighbourCacheIoTorii::STALE;
         }
         else
             //b. Otherwise, the received advertisement should be ignored and
             //MUST NOT update the cache.
-            EV_INFO << "NCE is not in REACHABLE state. Ignore NA.\n";
+            IOTORII_EV_INFO(ND) << "NCE is not in REACHABLE state. Ignore NA.\n";
     }
     else if (naOverrideFlag == true || naMacAddr.equals(nce->macAddress)
              || naMacAddr.isUnspecified())
     {
-        EV_INFO << "NA override flag is TRUE. or Advertised MAC is same as NCE's. or"
+        IOTORII_EV_INFO(ND) << "NA override flag is TRUE. or Advertised MAC is same as NCE's. or"
                 << " NA MAC is not specified.\n";
         /*II. If the Override flag is set, or the supplied link-layer address
            is the same as that in the cache, or no Target Link-layer address
@@ -2451,20 +2452,20 @@ void IPv6NeighbourDiscoveryIoTorii::processNAForOtherNCEStates(IPv6NeighbourAdve
             MUST be inserted in the cache (if one is supplied and is
             Different than the already recorded address).*/
         if (!(naMacAddr.isUnspecified()) && !(naMacAddr.equals(nce->macAddress))) {
-            EV_INFO << "Updating NCE's MAC addr with NA's.\n";
+            IOTORII_EV_INFO(ND) << "Updating NCE's MAC addr with NA's.\n";
             nce->macAddress = naMacAddr;
         }
 
         //- If the Solicited flag is set,
         if (naSolicitedFlag == true) {
-            EV_INFO << "Solicited Flag is TRUE. Set NCE state to REACHABLE.\n";
+            IOTORII_EV_INFO(ND) << "Solicited Flag is TRUE. Set NCE state to REACHABLE.\n";
             //the state of the entry MUST be set to REACHABLE.
             nce->reachabilityState = IPv6NeighbourCacheIoTorii::REACHABLE;
             //We have to cancel the NUD self timer message if there is one.
 
             cMessage *msg = nce->nudTimeoutEvent;
             if (msg != nullptr) {
-                EV_INFO << "NUD in progress. Cancelling NUD Timer\n";
+                IOTORII_EV_INFO(ND) << "NUD in progress. Cancelling NUD Timer\n";
                 bubble("Reachability Confirmed via NUD.");
                 nce->reachabilityExpires = simTime() + ie->ipv6Data()->_getReachableTime();
                 cancelAndDelete(msg);
@@ -2473,23 +2474,23 @@ void IPv6NeighbourDiscoveryIoTorii::processNAForOtherNCEStates(IPv6NeighbourAdve
         }
         else {
             //If the Solicited flag is zero
-            EV_INFO << "Solicited Flag is FALSE.\n";
+            IOTORII_EV_INFO(ND) << "Solicited Flag is FALSE.\n";
             //and the link layer address was updated with a different address
 
             if (!(naMacAddr.equals(nce->macAddress))) {
-                EV_INFO << "NA's MAC is different from NCE's.Set NCE state to STALE\n";
+                IOTORII_EV_INFO(ND) << "NA's MAC is different from NCE's.Set NCE state to STALE\n";
                 //the state MUST be set to STALE.
                 nce->reachabilityState = IPv6NeighbourCacheIoTorii::STALE;
             }
             else
                 //Otherwise, the entry's state remains unchanged.
-                EV_INFO << "NA's MAC is the same as NCE's. State remains unchanged.\n";
+                IOTORII_EV_INFO(ND) << "NA's MAC is the same as NCE's. State remains unchanged.\n";
         }
         //(Next paragraph with explanation is omitted.-WEI)
 
         /*- The IsRouter flag in the cache entry MUST be set based on the
            Router flag in the received advertisement.*/
-        EV_INFO << "Updating NCE's router flag to " << naRouterFlag << endl;
+        IOTORII_EV_INFO(ND) << "Updating NCE's router flag to " << naRouterFlag << endl;
         nce->isRouter = naRouterFlag;
 
         /*In those cases where the IsRouter flag changes from TRUE to FALSE as a
@@ -2544,13 +2545,13 @@ void IPv6NeighbourDiscoveryIoTorii::processRedirectPacket(IPv6Redirect *redirect
 //The overlaoded function has been added by zarrar yousaf on 20.07.07
 void IPv6NeighbourDiscoveryIoTorii::processRAPrefixInfoForAddrAutoConf(IPv6NDPrefixInformation& prefixInfo, InterfaceEntry *ie, bool hFlag)
 {
-    EV_INFO << "Processing Prefix Info for address auto-configuration.\n";
+    IOTORII_EV_INFO(ND) << "Processing Prefix Info for address auto-configuration.\n";
     IPv6Address prefix = prefixInfo.getPrefix();
     uint prefixLength = prefixInfo.getPrefixLength();
     simtime_t preferredLifetime = prefixInfo.getPreferredLifetime();
     simtime_t validLifetime = prefixInfo.getValidLifetime();
 
-    //EV << "/// prefix: " << prefix << std::endl; // CB
+    //IOTORII_EV(ND) << "/// prefix: " << prefix << std::endl; // CB
 
     //RFC 2461: Section 5.5.3
     //First condition tested, the autonomous flag is already set
@@ -2558,7 +2559,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAPrefixInfoForAddrAutoConf(IPv6NDPre
     //b) If the prefix is the link-local prefix, silently ignore the Prefix
     //Information option.
     if (prefixInfo.getPrefix().isLinkLocal() == true) {
-        EV_INFO << "Prefix is link-local, ignore Prefix Information Option\n";
+        IOTORII_EV_INFO(ND) << "Prefix is link-local, ignore Prefix Information Option\n";
         return;
     }
 
@@ -2566,7 +2567,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAPrefixInfoForAddrAutoConf(IPv6NDPre
     //ignore the Prefix Information option. A node MAY wish to log a system
     //management error in this case.
     if (preferredLifetime > validLifetime) {
-        EV_INFO << "Preferred lifetime is greater than valid lifetime, ignore Prefix Information\n";
+        IOTORII_EV_INFO(ND) << "Preferred lifetime is greater than valid lifetime, ignore Prefix Information\n";
         return;
     }
 
@@ -2599,7 +2600,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAPrefixInfoForAddrAutoConf(IPv6NDPre
                 returnedHome = true;
             else {
                 isPrefixAssignedToInterface = true;
-                EV_INFO << "The received Prefix is already assigned to the interface" << endl;    //Zarrar Yousaf 19.07.07
+                IOTORII_EV_INFO(ND) << "The received Prefix is already assigned to the interface" << endl;    //Zarrar Yousaf 19.07.07
                 break;
             }
         }
@@ -2610,14 +2611,14 @@ void IPv6NeighbourDiscoveryIoTorii::processRAPrefixInfoForAddrAutoConf(IPv6NDPre
          interface identifier as follows:
      */
     if ((isPrefixAssignedToInterface == false) && (validLifetime != 0)) {
-        EV_INFO << "Prefix not assigned to interface. Possible new router detected. Auto-configuring new address.\n";
+        IOTORII_EV_INFO(ND) << "Prefix not assigned to interface. Possible new router detected. Auto-configuring new address.\n";
         IPv6Address linkLocalAddress = ie->ipv6Data()->getLinkLocalAddress();
         ASSERT(linkLocalAddress.isUnspecified() == false);
         IPv6Address newAddr = linkLocalAddress.setPrefix(prefix, prefixLength);
         IPv6Address CoA;
         //TODO: for now we leave the newly formed address as not tentative,
         //according to Greg, we have to always perform DAD for a newly formed address.
-        EV_INFO << "Assigning new address to: " << ie->getName() << endl;
+        IOTORII_EV_INFO(ND) << "Assigning new address to: " << ie->getName() << endl;
 
         // we are for sure either in the home network or in a new foreign network
         // -> remove CoA
@@ -2627,7 +2628,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAPrefixInfoForAddrAutoConf(IPv6NDPre
         // 27.9.07 - CB
         if (returnedHome) {
             // we have to remove the CoA before we create a new one
-            EV_INFO << "Node returning home - removing CoA...\n";
+            IOTORII_EV_INFO(ND) << "Node returning home - removing CoA...\n";
             CoA = ie->ipv6Data()->removeAddress(IPv6InterfaceData::CoA);
 
             // nothing to do more wrt managing addresses, as we are at home and a HoA is
@@ -2657,7 +2658,7 @@ void IPv6NeighbourDiscoveryIoTorii::processRAPrefixInfoForAddrAutoConf(IPv6NDPre
                     // TODO improve this code so that only addresses are set to tentative which are
                     // formed based on the link-local address from above
                     ie->ipv6Data()->tentativelyAssign(j);
-                    EV_INFO << "Setting address " << ie->ipv6Data()->getAddress(j) << " to tentative.\n";
+                    IOTORII_EV_INFO(ND) << "Setting address " << ie->ipv6Data()->getAddress(j) << " to tentative.\n";
                 }
 
                 initiateDAD(ie->ipv6Data()->getLinkLocalAddress(), ie);
@@ -2688,7 +2689,7 @@ void IPv6NeighbourDiscoveryIoTorii::routersUnreachabilityDetection(const Interfa
         if ((*it).first.interfaceID == ie->getInterfaceId() && it->second.isDefaultRouter()) {
             // update 14.9.07 - CB
             IPv6Address rtrLnkAddress = (*it).first.address;
-            EV_INFO << "Setting router (address=" << rtrLnkAddress << ", ifID="
+            IOTORII_EV_INFO(ND) << "Setting router (address=" << rtrLnkAddress << ", ifID="
                     << (*it).first.interfaceID << ") to unreachable" << endl;
             ++it;
 
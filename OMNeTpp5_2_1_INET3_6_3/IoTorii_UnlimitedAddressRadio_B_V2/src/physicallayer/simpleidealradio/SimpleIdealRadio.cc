@@ -133,7 +133,7 @@ void SimpleIdealRadio::handleUpperPacket(cPacket *packet)
 void SimpleIdealRadio::handleLowerPacket(SimpleRadioFrame *radioFrame)
 {
 
-    EV_INFO << "Reception started: " << radioFrame->getName() << endl;
+    EV_INFO << "Reception started: " << radioFrame->getEncapsulatedPacket()->getName() << endl;
     cPacket *macFrame = radioFrame->decapsulate();
     sendUp(macFrame);
 }
@@ -24,6 +24,10 @@
 //
 
 #include "src/physicallayer/simpleidealradio/SimpleIdealRadioMedium.h"
+#include "src/linklayer/common/IoToriiLog.h"
+
+#include <algorithm>
+#include <cmath>
 
 namespace iotorii {
 
@@ -41,7 +45,9 @@ SimpleIdealRadioMedium::SimpleIdealRadioMedium()
 
 SimpleIdealRadioMedium::~SimpleIdealRadioMedium()
 {
-
+    cModule *systemModule = getSimulation()->getSystemModule();
+    if ((systemModule != nullptr) && systemModule->isSubscribed(IMobility::mobilityStateChangedSignal, this))
+        systemModule->unsubscribe(IMobility::mobilityStateChangedSignal, this);
 }
 
 void SimpleIdealRadioMedium::initialize(int stage)
@@ -49,9 +55,13 @@ void SimpleIdealRadioMedium::initialize(int stage)
     if (stage == INITSTAGE_LOCAL) {
         // initialize parameters
         //WATCH_VECTOR(radios);
+        useSpatialGrid = par("useSpatialGrid");
+        cacheNeighbors = par("cacheNeighbors");
+        if (useSpatialGrid || cacheNeighbors)
+            getSimulation()->getSystemModule()->subscribe(IMobility::mobilityStateChangedSignal, this);
     }
     else if (stage == INITSTAGE_LAST)
-        EV_INFO << "Initialized " << endl;
+        IOTORII_EV_INFO(MEDIUM) << "Initialized " << endl;
 }
 
 void SimpleIdealRadioMedium::handleMessage(cMessage *message)
@@ -64,20 +74,146 @@ void SimpleIdealRadioMedium::finish()
 
 }
 
+void SimpleIdealRadioMedium::receiveSignal(cComponent *source, simsignal_t signal, cObject *value, cObject *details)
+{
+    if (signal == IMobility::mobilityStateChangedSignal) {
+        auto it = mobilityIndex.find(source);
+        if (it == mobilityIndex.end())
+            return;
+        neighborCacheGeneration++;
+        if (useSpatialGrid && !radios[it->second].isPositionChanged) {
+            radios[it->second].isPositionChanged = true;
+            changedRadios.push_back(it->second);
+        }
+    }
+}
+
+static int getCellCoordinate(double value, double cellSize)
+{
+    if (!(cellSize > 0) || !std::isfinite(value))
+        return 0;
+    double coordinate = std::floor(value / cellSize);
+    // far away cells are merged, it only costs some distance calculations
+    return (int)std::max(-1073741824.0, std::min(1073741824.0, coordinate));
+}
+
+static uint64 packCell(int x, int y)
+{
+    return ((uint64)(uint32_t)x << 32) | (uint32_t)y;
+}
+
+uint64 SimpleIdealRadioMedium::getCell(const Coord& position) const
+{
+    return packCell(getCellCoordinate(position.x, cellSize), getCellCoordinate(position.y, cellSize));
+}
+
+void SimpleIdealRadioMedium::addToGrid(unsigned int index)
+{
+    RadioEntry& entry = radios[index];
+    entry.cell = getCell(entry.position);
+    std::vector<unsigned int>& cell = grid[entry.cell];
+    entry.indexInCell = cell.size();
+    cell.push_back(index);
+}
+
+void SimpleIdealRadioMedium::removeFromGrid(unsigned int index)
+{
+    RadioEntry& entry = radios[index];
+    auto it = grid.find(entry.cell);
+    if (it == grid.end())
+        throw cRuntimeError("SimpleIdealRadioMedium: radio is not in its grid cell");
+    std::vector<unsigned int>& cell = it->second;
+    // the order in a cell does not matter, sendToNeighbors() sorts the candidates
+    cell[entry.indexInCell] = cell.back();
+    radios[cell[entry.indexInCell]].indexInCell = entry.indexInCell;
+    cell.pop_back();
+    if (cell.empty())
+        grid.erase(it);
+}
+
+void SimpleIdealRadioMedium::updateChangedPositions()
+{
+    std::vector<unsigned int> changed;
+    changed.swap(changedRadios);
+    for (auto index : changed) {
+        radios[index].isPositionChanged = false;
+        if (radios[index].radio == nullptr)
+            continue;
+        Coord position = radios[index].radio->getMobility()->getCurrentPosition();
+        if (getCell(position) != radios[index].cell) {
+            removeFromGrid(index);
+            radios[index].position = position;
+            addToGrid(index);
+        }
+        else
+            radios[index].position = position;
+    }
+}
+
+void SimpleIdealRadioMedium::rebuildIndexes()
+{
+    std::vector<RadioEntry> oldRadios;
+    oldRadios.swap(radios);
+    radioIndex.clear();
+    mobilityIndex.clear();
+    grid.clear();
+    changedRadios.clear();
+    numRemovedRadios = 0;
+    neighborCacheGeneration++;  // the indexes change
+    for (auto & entry : oldRadios) {
+        if (entry.radio == nullptr)
+            continue;
+        unsigned int index = radios.size();
+        radios.push_back(entry);
+        radioIndex[entry.radio] = index;
+        if (entry.mobility != nullptr)
+            mobilityIndex[entry.mobility] = index;
+        if (useSpatialGrid) {
+            addToGrid(index);
+            if (entry.isPositionChanged)
+                changedRadios.push_back(index);
+        }
+    }
+}
+
 void SimpleIdealRadioMedium::addRadio(SimpleIdealRadio *radio)
 {
-    radios.push_back(radio);
+    unsigned int index = radios.size();
+    radios.push_back(RadioEntry());
+    radios[index].radio = radio;
+    radios[index].mobility = dynamic_cast<cComponent *>(radio->getMobility());
+    radioIndex[radio] = index;
+    neighborCacheGeneration++;
+    if (radios[index].mobility != nullptr)
+        mobilityIndex[radios[index].mobility] = index;
+    if (useSpatialGrid) {
+        radios[index].position = radio->getMobility()->getCurrentPosition();
+        if (radio->getCommunicationRange().get() > cellSize) {
+            cellSize = radio->getCommunicationRange().get();
+            rebuildIndexes();
+        }
+        else
+            addToGrid(index);
+    }
 }
 
 void SimpleIdealRadioMedium::removeRadio(SimpleIdealRadio *radio)
 {
-    int radioIndex = radio->getId() - radios[0]->getId();
-    radios[radioIndex] = nullptr;
-    int radioCount = 0;
-    while (radios[radioCount] == nullptr && radioCount < (int)radios.size())
-        radioCount++;
-    if (radioCount != 0)
-        radios.erase(radios.begin(), radios.begin() + radioCount);
+    auto it = radioIndex.find(radio);
+    if (it == radioIndex.end())
+        return;
+    unsigned int index = it->second;
+    radioIndex.erase(it);
+    neighborCacheGeneration++;
+    if (useSpatialGrid)
+        removeFromGrid(index);
+    mobilityIndex.erase(radios[index].mobility);
+    radios[index].radio = nullptr;
+    radios[index].mobility = nullptr;
+    numRemovedRadios++;
+    // compaction keeps the order, and it is amortized O(1) per removal
+    if (2 * numRemovedRadios > radios.size())
+        rebuildIndexes();
 }
 
 SimpleRadioFrame *SimpleIdealRadioMedium::startTransmission(cModule *transmitter, Coord startPosition, cPacket *macFrame)
@@ -87,7 +223,7 @@ SimpleRadioFrame *SimpleIdealRadioMedium::startTransmission(cModule *transmitter
     SimpleRadioFrame *radioFrame = new SimpleRadioFrame;
     //radioFrame->setStartPosition( startPosition);
     radioFrame->encapsulate(macFrame);
-    radioFrame->setName(macFrame->getName());
+    radioFrame->setKind(macFrame->getKind());    //the name is not copied, see the encapsulated frame
 
     SimpleIdealRadio *transmitterRadio = check_and_cast<SimpleIdealRadio *>(transmitter);
     sendToNeighbors(transmitterRadio, radioFrame);
@@ -95,31 +231,85 @@ SimpleRadioFrame *SimpleIdealRadioMedium::startTransmission(cModule *transmitter
     return radioFrame;
 }
 
-void SimpleIdealRadioMedium::sendToNeighbors(SimpleIdealRadio *transmitter, SimpleRadioFrame *radioFrame)
+void SimpleIdealRadioMedium::findNeighbors(SimpleIdealRadio *transmitter, std::vector<unsigned int>& neighbors)
 {
 
     Coord transmitterPosition = transmitter->getMobility()->getCurrentPosition();
     m communicationRange = transmitter->getCommunicationRange();
     //double communicationRange = transmitter->getCommunicationRange();
+
+    if (useSpatialGrid) {
+        updateChangedPositions();
+        // cellSize is the largest range, so the 3x3 cells around the transmitter contain all receivers
+        int cellX = getCellCoordinate(transmitterPosition.x, cellSize);
+        int cellY = getCellCoordinate(transmitterPosition.y, cellSize);
+        candidates.clear();
+        for (int x = cellX - 1; x <= cellX + 1; x++)
+            for (int y = cellY - 1; y <= cellY + 1; y++) {
+                auto it = grid.find(packCell(x, y));
+                if (it != grid.end())
+                    candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+            }
+        // same delivery order as the linear scan
+        std::sort(candidates.begin(), candidates.end());
+        for (auto index : candidates) {
+            SimpleIdealRadio *receiver = radios[index].radio;
+            if (receiver == transmitter)
+                continue;
+            double distance = transmitterPosition.distance(radios[index].position);
+            if (distance < communicationRange.get()) {
+                IOTORII_EV_DEBUG(MEDIUM) << "Successfull, " << getContainingNode(transmitter)->getFullName() << "sends the packet to the "
+                        << getContainingNode(receiver)->getFullName() << ", distance is " << distance
+                        << "communication range is " << communicationRange << endl;
+                neighbors.push_back(index);
+            }
+        }
+        return;
+    }
+
     //for(int i=0; i<radios.size(); i++){
-    for (auto receiver : radios)
-        if ((receiver != nullptr) && (receiver != transmitter)){
+    for (unsigned int index = 0; index < radios.size(); index++)
+        if ((radios[index].radio != nullptr) && (radios[index].radio != transmitter)){
+            SimpleIdealRadio *receiver = radios[index].radio;
             double distance = transmitterPosition.distance(receiver->getMobility()->getCurrentPosition());
             if (distance < communicationRange.get()){  //if (distance <= communicationRange.get()){
             //if (distance <= communicationRange){
-                 EV << "Successfull, " << getContainingNode(transmitter)->getFullName() << "sends the packet to the "
+                 IOTORII_EV_DEBUG(MEDIUM) << "Successfull, " << getContainingNode(transmitter)->getFullName() << "sends the packet to the "
                         << getContainingNode(receiver)->getFullName() << ", distance is " << distance
                         << "communication range is " << communicationRange << endl;
 
 
 
-                sendToRadio(transmitter, receiver, radioFrame->dup());
+                neighbors.push_back(index);
         }else
-            EV << "Ignored, " << getContainingNode(transmitter)->getFullName() << "sends the packet to the "
+            IOTORII_EV_DEBUG(MEDIUM) << "Ignored, " << getContainingNode(transmitter)->getFullName() << "sends the packet to the "
                    << getContainingNode(receiver)->getFullName() << ", distance is " << distance
                    << "communication range is " << communicationRange << endl;
 
     }
+}
+
+void SimpleIdealRadioMedium::sendToNeighbors(SimpleIdealRadio *transmitter, SimpleRadioFrame *radioFrame)
+{
+    std::vector<unsigned int> *receivers = &receiverBuffer;
+    auto it = radioIndex.find(transmitter);
+    if (cacheNeighbors && (it != radioIndex.end())) {
+        // computed at the first transmission after the last change of the radios, then a plain array walk
+        RadioEntry& entry = radios[it->second];
+        if (entry.neighborsGeneration != neighborCacheGeneration) {
+            entry.neighbors.clear();
+            findNeighbors(transmitter, entry.neighbors);
+            entry.neighborsGeneration = neighborCacheGeneration;
+        }
+        receivers = &entry.neighbors;
+    }
+    else {
+        receiverBuffer.clear();
+        findNeighbors(transmitter, receiverBuffer);
+    }
+
+    for (auto index : *receivers)
+        sendToRadio(transmitter, radios[index].radio, radioFrame->dup());
 
     delete radioFrame;
 /*    double a=9.6000000000000000, b=19.600000000000000, c=b-a, d,e,f;
@@ -129,17 +319,17 @@ void SimpleIdealRadioMedium::sendToNeighbors(SimpleIdealRadio *transmitter, Simp
       f = ceilf(a * 100) / 100;  //rounded_up
 
     if ( c== 10)
-        EV << "ok1 b-a == 10" << endl;
+        IOTORII_EV(MEDIUM) << "ok1 b-a == 10" << endl;
     if (a<=b-10)
-        EV << "ok2 a<=b-10" << endl;
+        IOTORII_EV(MEDIUM) << "ok2 a<=b-10" << endl;
         */
 }
 
 void SimpleIdealRadioMedium::sendToAllRadios(SimpleIdealRadio *transmitter, SimpleRadioFrame *frame)
 {
-    for (auto radio : radios)
-        if (radio != nullptr)
-            sendToRadio(transmitter, radio, frame->dup());
+    for (auto & entry : radios)
+        if (entry.radio != nullptr)
+            sendToRadio(transmitter, entry.radio, frame->dup());
     delete frame;
 }
 
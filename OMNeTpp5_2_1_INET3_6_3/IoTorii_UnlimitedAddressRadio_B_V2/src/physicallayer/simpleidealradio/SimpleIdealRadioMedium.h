@@ -34,6 +34,8 @@
 #include "inet/common/ModuleAccess.h"
 #include "inet/common/Units.h"
 
+#include <unordered_map>
+
 
 namespace iotorii {
 
@@ -44,20 +46,69 @@ using namespace physicallayer;
 
 class SimpleIdealRadio;
 
-class SimpleIdealRadioMedium : public cSimpleModule
+class SimpleIdealRadioMedium : public cSimpleModule, public cListener
 {
 
   protected:
+    struct RadioEntry
+    {
+        SimpleIdealRadio *radio = nullptr;    // nullptr if the radio is removed
+        cComponent *mobility = nullptr;    // source of its mobilityStateChangedSignal
+        Coord position;    // at the last mobility signal
+        uint64 cell = 0;    // grid cell of position
+        unsigned int indexInCell = 0;    // in grid[cell]
+        bool isPositionChanged = false;    // it is in changedRadios
+        std::vector<unsigned int> neighbors;    // cached receivers of this radio, indexes in radios
+        unsigned long neighborsGeneration = 0;    // neighbors is valid if it equals neighborCacheGeneration
+    };
+
+    /** @name Parameters */
+    //@{
+    bool useSpatialGrid = true;
+    bool cacheNeighbors = true;
+    //@}
 
     /** @name State */
     //@{
     /**
      * The list of radios that can transmit and receive radio signals on the
-     * radio medium. The radios follow each other in the order of their unique
-     * id. Radios are only removed from the beginning. This list may contain
-     * nullptr values.
+     * radio medium. The radios follow each other in the order of addRadio(),
+     * which is also the order of delivery. Removed radios leave a nullptr radio
+     * that is compacted away when they are the majority.
+     */
+    std::vector<RadioEntry> radios;
+    unsigned int numRemovedRadios = 0;
+    std::unordered_map<const SimpleIdealRadio *, unsigned int> radioIndex;    // radio -> index in radios
+    std::unordered_map<const cComponent *, unsigned int> mobilityIndex;    // mobility module -> index in radios
+
+    /**
+     * Uniform grid on the x-y plane. The cell size is the largest communication range,
+     * so the receivers of a transmission are in the cells around the cell of the transmitter.
+     */
+    std::unordered_map<uint64, std::vector<unsigned int>> grid;    // cell -> indexes in radios
+    double cellSize = 0;    // meters
+    std::vector<unsigned int> changedRadios;    // radios whose position is updated by the next transmission
+    std::vector<unsigned int> candidates;    // buffer of findNeighbors()
+    std::vector<unsigned int> receiverBuffer;    // buffer of sendToNeighbors() without cacheNeighbors
+    unsigned long neighborCacheGeneration = 1;    // incremented when a radio moves, is added or removed
+    //@}
+
+  protected:
+    uint64 getCell(const Coord& position) const;
+    void addToGrid(unsigned int index);
+    void removeFromGrid(unsigned int index);
+
+    /**
+     * @brief Reads the current position of the radios moved since the last transmission.
+     * It is not done in receiveSignal(), because getCurrentPosition() may emit the signal again.
+     */
+    void updateChangedPositions();
+    void rebuildIndexes();
+
+    /**
+     * @brief Appends the indexes of the radios in the communication range of transmitter, in delivery order
      */
-    std::vector<SimpleIdealRadio *> radios;
+    void findNeighbors(SimpleIdealRadio *transmitter, std::vector<unsigned int>& neighbors);
 
   public:
     SimpleIdealRadioMedium();
@@ -67,6 +118,7 @@ class SimpleIdealRadioMedium : public cSimpleModule
     virtual void initialize(int stage) override;
     virtual void handleMessage(cMessage *message) override;
     virtual void finish() override;
+    virtual void receiveSignal(cComponent *source, simsignal_t signal, cObject *value, cObject *details) override;
 
   public:
     virtual void addRadio(SimpleIdealRadio *radio);
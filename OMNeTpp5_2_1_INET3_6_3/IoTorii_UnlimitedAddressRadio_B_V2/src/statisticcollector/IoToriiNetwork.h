@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2018 Elisa Rojas(1), Hedayat Hosseini(2), Carles Gomez(3);
+ *                    (1) GIST, University of Alcala, Spain.
+ *                    (2) CEIT, Amirkabir University of Technology (Tehran Polytechnic), Iran.
+ *                    (3) UPC, Castelldefels, Spain.
+ *
+ */
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef IOTORII_SRC_STATISTIC_IOTORIINETWORK_H
+#define IOTORII_SRC_STATISTIC_IOTORIINETWORK_H
+
+#include "inet/common/INETDefs.h"
+
+namespace iotorii {
+using namespace inet;
+
+/**
+ * Network module class (@class of the network, e.g. ScalabilityNet) which saves the peak RSS of the
+ * process when the network module is created, i.e. before its submodules are built, so that
+ * StatisticCollector can tell the memory of the network from the fixed memory of the process.
+ */
+class IoToriiNetwork : public cModule
+{
+  protected:
+    double peakRSSBeforeSetup;    // peak RSS (bytes) before the submodules are built, -1 if it is not known
+
+  public:
+    IoToriiNetwork() : peakRSSBeforeSetup(getPeakRSS()) {}
+
+    double getPeakRSSBeforeSetup() const { return peakRSSBeforeSetup; }
+
+    /**
+     * @brief Peak resident set size of the process in bytes, -1 if it is not known
+     */
+    static double getPeakRSS();
+};
+
+} // namespace iotorii
+
+#endif // ifndef IOTORII_SRC_STATISTIC_IOTORIINETWORK_H
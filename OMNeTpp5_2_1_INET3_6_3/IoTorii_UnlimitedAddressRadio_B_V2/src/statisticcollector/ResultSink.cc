@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2018 Elisa Rojas(1), Hedayat Hosseini(2), Carles Gomez(3);
+ *                    (1) GIST, University of Alcala, Spain.
+ *                    (2) CEIT, Amirkabir University of Technology (Tehran Polytechnic), Iran.
+ *                    (3) UPC, Castelldefels, Spain.
+ *
+ */
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include "src/statisticcollector/ResultSink.h"
+
+namespace iotorii {
+using namespace inet;
+
+ResultSink::HopMatrixFormat ResultSink::parseHopMatrixFormat(const char *format)
+{
+    if (strcmp(format, "none") == 0)
+        return HOP_MATRIX_NONE;
+    if (strcmp(format, "full") == 0)
+        return HOP_MATRIX_FULL;
+    if (strcmp(format, "packed") == 0)
+        return HOP_MATRIX_PACKED;
+    throw cRuntimeError("ResultSink: unknown hop matrix format '%s', it must be none, full or packed", format);
+}
+
+void ResultSink::appendText(const char *fileName, const char *format, ...)
+{
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0)
+        throw cRuntimeError("ResultSink::appendText(): invalid format '%s'", format);
+
+    std::string& text = textFiles[fileName];
+    if (length < (int)sizeof(buffer))
+        text.append(buffer, length);
+    else{
+        std::vector<char> longBuffer(length + 1);
+        va_start(args, format);
+        vsnprintf(longBuffer.data(), longBuffer.size(), format, args);
+        va_end(args);
+        text.append(longBuffer.data(), length);
+    }
+}
+
+void ResultSink::setRunKey(const std::string& config, int runNumber, const std::string& seedset)
+{
+    this->config = config;
+    this->runNumber = runNumber;
+    this->seedset = seedset;
+}
+
+void ResultSink::putString(const std::string& value)
+{
+    putUInt32(value.size());
+    record.append(value);
+}
+
+void ResultSink::putVarint(uint32_t value)
+{
+    while (value >= 0x80){
+        record.push_back((char)((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    record.push_back((char)value);
+}
+
+void ResultSink::buildRecord()
+{
+    unsigned int numNodes = (hopMatrix == nullptr) ? 0 : hopMatrix->size();    // rows of the matrix, see the record format
+
+    record.clear();
+    putString(config);
+    putUInt32((uint32_t)runNumber);
+    putString(seedset);
+    putUInt32(numNodes);
+    putUInt32(columns.size());
+    for (auto & column : columns){
+        putString(column.first);
+        record.append((const char *)&column.second, sizeof(column.second));
+    }
+
+    HopMatrixFormat format = (hopMatrix == nullptr) ? HOP_MATRIX_NONE : hopMatrixFormat;
+    if (format == HOP_MATRIX_PACKED){
+        for (unsigned int i = 0; (i < numNodes) && (format == HOP_MATRIX_PACKED); i++)
+            for (unsigned int j = i + 1; j < numNodes; j++)
+                if ((*hopMatrix)[i][j] != (*hopMatrix)[j][i]){
+                    format = HOP_MATRIX_FULL;
+                    break;
+                }
+    }
+    record.push_back((char)format);
+    if (format == HOP_MATRIX_FULL){
+        record.reserve(record.size() + numNodes * numNodes * sizeof(int32_t));
+        for (auto & row : *hopMatrix)
+            for (int hops : row){
+                int32_t value = hops;
+                record.append((const char *)&value, sizeof(value));
+            }
+    }else if (format == HOP_MATRIX_PACKED){
+        for (unsigned int i = 0; i < numNodes; i++)
+            for (unsigned int j = i + 1; j < numNodes; j++)
+                putVarint((uint32_t)((*hopMatrix)[i][j] + 1));
+    }
+}
+
+void ResultSink::writeFile(const std::string& fileName, const std::string& data)
+{
+    FILE *file = fopen(fileName.c_str(), "ab");
+    if (file == nullptr)
+        throw cRuntimeError("ResultSink: cannot open %s", fileName.c_str());
+    size_t written = fwrite(data.data(), 1, data.size(), file);
+    if ((fclose(file) != 0) || (written != data.size()))
+        throw cRuntimeError("ResultSink: cannot write %s", fileName.c_str());
+}
+
+void ResultSink::flush(const std::string& binaryFileName)
+{
+    for (auto & elem : textFiles)
+        writeFile(elem.first, elem.second);
+    textFiles.clear();
+
+    if (!binaryFileName.empty()){
+        buildRecord();
+        std::string header;
+        uint32_t values[3] = { MAGIC, VERSION, (uint32_t)record.size() };
+        header.append((const char *)values, sizeof(values));
+        writeFile(binaryFileName, header + record);
+    }
+    record.clear();
+    columns.clear();
+    hopMatrix = nullptr;
+}
+
+} // namespace iotorii
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2018 Elisa Rojas(1), Hedayat Hosseini(2), Carles Gomez(3);
+ *                    (1) GIST, University of Alcala, Spain.
+ *                    (2) CEIT, Amirkabir University of Technology (Tehran Polytechnic), Iran.
+ *                    (3) UPC, Castelldefels, Spain.
+ *
+ */
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef IOTORII_SRC_STATISTIC_RESULTSINK_H
+#define IOTORII_SRC_STATISTIC_RESULTSINK_H
+
+#include "inet/common/INETDefs.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace iotorii {
+using namespace inet;
+
+/**
+ * Buffers the results of one run and writes each output file once, by flush().
+ *
+ * Text files (appendText()) are the former per-metric files; each is appended with one fwrite().
+ *
+ * The binary file gets one record per run, appended. Integers and doubles are in native byte order
+ * (the magic number tells it), strings are a uint32 length followed by the characters:
+ *   uint32 magic (0x52544F49, "IOTR" in little-endian), uint32 version (1),
+ *   uint32 size of the rest of the record in bytes (a reader can skip records),
+ *   string config, int32 run number, string seedset,
+ *   uint32 number of hop matrix rows N (the number of nodes, the sampled sources if hopCountSources > 0
+ *   in StatisticCollector, 0 without a matrix), uint32 number of columns C, C * (string name, double value),
+ *   uint8 hop matrix format, then by format:
+ *     HOP_MATRIX_NONE:   nothing (always for a sampled matrix)
+ *     HOP_MATRIX_FULL:   N * N int32, row-major
+ *     HOP_MATRIX_PACKED: the upper triangle (i < j) of the symmetric matrix row-major, each hop count h
+ *                        as the LEB128 varint of h + 1 (so -1 is 0), usually one byte per pair
+ * The column names are the same in all records of a run configuration, so the file is a table of runs.
+ */
+class ResultSink
+{
+  public:
+    enum HopMatrixFormat { HOP_MATRIX_NONE = 0, HOP_MATRIX_FULL = 1, HOP_MATRIX_PACKED = 2 };
+
+    static const uint32_t MAGIC = 0x52544F49;
+    static const uint32_t VERSION = 1;
+
+  protected:
+    std::map<std::string, std::string> textFiles;    // file name -> buffered text
+    std::string record;    // binary record of the run, without its header
+    std::vector<std::pair<std::string, double>> columns;
+    const std::vector<std::vector<int>> *hopMatrix = nullptr;
+    HopMatrixFormat hopMatrixFormat = HOP_MATRIX_NONE;
+    std::string config;
+    int runNumber = -1;
+    std::string seedset;
+
+  protected:
+    void putUInt32(uint32_t value) { record.append((const char *)&value, sizeof(value)); }
+    void putString(const std::string& value);
+    void putVarint(uint32_t value);
+    void buildRecord();
+    static void writeFile(const std::string& fileName, const std::string& data);
+
+  public:
+    /**
+     * @brief Parses "none", "full" or "packed"
+     */
+    static HopMatrixFormat parseHopMatrixFormat(const char *format);
+
+    /**
+     * @brief Appends printf formatted text to the buffer of the text file fileName
+     */
+    void appendText(const char *fileName, const char *format, ...);
+
+    void setRunKey(const std::string& config, int runNumber, const std::string& seedset);
+
+    void addColumn(const char *name, double value) { columns.push_back(std::make_pair(std::string(name), value)); }
+
+    /**
+     * @brief The matrix is read by flush(), so it must live until then. PACKED is written as FULL if the matrix is not symmetric.
+     */
+    void setHopMatrix(const std::vector<std::vector<int>> *hopMatrix, HopMatrixFormat format) { this->hopMatrix = hopMatrix; hopMatrixFormat = format; }
+
+    /**
+     * @brief Writes the buffered text files and, if binaryFileName is not empty, appends the record of the run to it.
+     * The buffers are cleared.
+     */
+    void flush(const std::string& binaryFileName);
+};
+
+} // namespace iotorii
+
+#endif // ifndef IOTORII_SRC_STATISTIC_RESULTSINK_H
@@ -20,10 +20,19 @@
 //
 
 #include <vector>
+#include <map>
+#include <climits>
+#include <thread>
+#include <exception>
+#include <system_error>
+#include <chrono>
 #include "src/statisticcollector/StatisticCollector.h"
-#include "inet/networklayer/contract/IInterfaceTable.h"
-#include "inet/networklayer/common/L3AddressResolver.h"
-//#include <algorithm>    // std::sort
+#include "src/statisticcollector/IoToriiNetwork.h"
+#include "src/linklayer/IoTorii/SetHLMACFrame.h"
+#include "src/linklayer/IoTorii/HLMACAddressTable.h"
+#include "src/linklayer/simpleidealmac/SimpleIdealWirelessMAC.h"
+#include "inet/common/ModuleAccess.h"
+#include <algorithm>
 
 
 namespace iotorii {
@@ -31,15 +40,60 @@ using namespace inet;
 
 Define_Module(StatisticCollector);
 
+//emitted by IoToriiOperation, see IoToriiSignals.h
+static simsignal_t coreStartedSignal = cComponent::registerSignal("coreStarted");
+static simsignal_t hlmacAssignedSignal = cComponent::registerSignal("hlmacAssigned");
+static simsignal_t hlmacRemovedSignal = cComponent::registerSignal("hlmacRemoved");  //emitted by HLMACAddressTable
+static simsignal_t setHLMACReceivedSignal = cComponent::registerSignal("setHLMACReceived");
+static simsignal_t helloSentSignal = cComponent::registerSignal("helloSent");
+static simsignal_t setHLMACSentSignal = cComponent::registerSignal("setHLMACSent");
+static simsignal_t neighborAddedSignal = cComponent::registerSignal("neighborAdded");
+
     //if ((NodeCounter_Upward[Version]<NodesNumber)&&(!IsDODAGFormed_Upward)) NodeStateLast->DIO.Received++;  //if simulation is not end ...
 
 void StatisticCollector::initialize(int stage)
 {
     if (stage == INITSTAGE_LOCAL){
         simulationTimeInterval = par("simulationTimeInterval");
+        const char *resultFormat = par("resultFormat");
+        if ((strcmp(resultFormat, "text") != 0) && (strcmp(resultFormat, "binary") != 0) && (strcmp(resultFormat, "both") != 0))
+            throw cRuntimeError("Unknown resultFormat '%s', it must be text, binary or both", resultFormat);
+        writeTextFiles = (strcmp(resultFormat, "binary") != 0);
+        resultFile = (strcmp(resultFormat, "text") != 0) ? par("resultFile").stdstringValue() : "";
+        hopMatrixFormat = ResultSink::parseHopMatrixFormat(par("hopMatrixFormat"));
+        numHopCountSources = par("hopCountSources");
+        checkUniqueAddresses = par("checkUniqueAddresses");
+        if (numHopCountSources < 0)
+            throw cRuntimeError("hopCountSources must not be negative");
+        int threads = par("numThreads");
+        if (threads < 0)
+            throw cRuntimeError("numThreads must not be negative");
+        numThreads = (threads == 0) ? std::thread::hardware_concurrency() : threads;
+        if (numThreads == 0)  //hardware_concurrency() is not known
+            numThreads = 1;
+#ifdef HLMAC_BENCHMARK
+        hlmacCopiesAtStart = HLMACAddress::numCopies;
+        hlmacHeapAllocationsAtStart = HLMACAddress::numHeapAllocations;
+        setHLMACFrameCopiesAtStart = SetHLMACFrame::numCopies;
+        targetOptionArraysAtStart = SetHLMACFrame::numTargetOptionArrays;
+#endif
+
+        //signals of all nodes propagate up to the network module
+        cModule *network = getSimulation()->getSystemModule();
+        network->subscribe(coreStartedSignal, this);
+        network->subscribe(hlmacAssignedSignal, this);
+        network->subscribe(hlmacRemovedSignal, this);
+        network->subscribe(setHLMACReceivedSignal, this);
+        network->subscribe(helloSentSignal, this);
+        network->subscribe(setHLMACSentSignal, this);
+        network->subscribe(neighborAddedSignal, this);
     }else if(stage == INITSTAGE_LINK_LAYER)
     {
         extractTopology();
+    }else if(stage == INITSTAGE_LAST)
+    {
+        wallClockAtStart = std::chrono::steady_clock::now();
+        eventNumberAtStart = getSimulation()->getEventNumber();
     }
 }
 
@@ -54,6 +108,10 @@ void StatisticCollector::extractTopology()
 
     // fill in nodeStateListVector (isHost and names) and HostInfoVector (IP and MAC addresses)
     nodeStateList.resize(topo.getNumNodes());
+    nodeIndexOfMAC.clear();
+    nodeIndexOfMAC.reserve(topo.getNumNodes());
+    nodeIndexOfModuleId.clear();
+    nodeIndexOfModuleId.reserve(topo.getNumNodes());
     unsigned int nWSN = 0;
 
     for (unsigned int i=0; i<topo.getNumNodes(); i++)
@@ -64,29 +122,23 @@ void StatisticCollector::extractTopology()
         if (std::string(newWSN.host->getNedTypeName()).find("WSNHostIoTorii") != std::string::npos) //such as: WSNHostIoTorii, ...
         {
             newWSN.fullName = std::string(newWSN.host->getFullName());
-            newWSN.ioToriiOperation = check_and_cast<IoToriiOperation *>(newWSN.host->getSubmodule("wlan", 0)->getSubmodule("mac")->getSubmodule("IoTorii"));
-            newWSN.hlmacAddressTable = check_and_cast<IHLMACAddressTable *>(newWSN.host->getSubmodule("hlmacTable"));
-            IInterfaceTable *ift = L3AddressResolver().interfaceTableOf(newWSN.host);
-
-            int nInterfaces = ift->getNumInterfaces();
-            if(nInterfaces > 2) //If host has more than 2 interfaces...
-                error("The host has more than 2 interfaces (one connected and loopback) and that's still not implemented!");
-            for (unsigned int k=0; k<nInterfaces; k++)
+            //The MAC address is read from the MAC module of the NIC, not from the interface table, which WSNHostIoToriiLite does not have
+            int nRadios = newWSN.host->par("numRadios");
+            if(nRadios > 1) //If host has more than 1 wireless interface...
+                error("The host has more than 1 wireless interface and that's still not implemented!");
+            if (nRadios == 1)
             {
-                InterfaceEntry *ie = ift->getInterface(k);
-                //We add only the info about the entry which is not the loopback
-                if (!ie->isLoopback())
-                {
-                    //newWSN.ipAddress = ie->ipv6Data()->getLinkLocalAddress();
-                    newWSN.macAddress = ie->getMacAddress();
-                    newWSN.moduleIndex = newWSN.host->getIndex();
-                    EV << "        " << newWSN.fullName << "->"<< " MAC: " << newWSN.macAddress << "; Module Index: " << newWSN.moduleIndex << "; Vector index: " << i <<endl;
-                }
+                cModule *mac = newWSN.host->getSubmodule("wlan", 0)->getModuleByPath(".mac.simpleidealwirelessMAC");
+                newWSN.macAddress = check_and_cast<SimpleIdealWirelessMAC *>(mac)->getMACAddress();
+                newWSN.moduleIndex = newWSN.host->getIndex();
+                EV << "        " << newWSN.fullName << "->"<< " MAC: " << newWSN.macAddress << "; Module Index: " << newWSN.moduleIndex << "; Vector index: " << i <<endl;
             }
             if (newWSN.macAddress == MACAddress::UNSPECIFIED_ADDRESS){
                 throw cRuntimeError("Host has not MAC address!");
             }
             nodeStateList.at(i) = (newWSN);
+            nodeIndexOfMAC.insert(std::make_pair(newWSN.macAddress.getInt(), i));  //the first node wins if a MAC address is repeated, as in the former linear search
+            nodeIndexOfModuleId.insert(std::make_pair(newWSN.host->getId(), i));
         }else{
             throw cRuntimeError("Host is not an IoTorii host!");
         }
@@ -95,39 +147,82 @@ void StatisticCollector::extractTopology()
     EV << "<-StatisticCollector::extractTopology()" << endl;
 }
 
-void StatisticCollector::startStatistics(const MACAddress &sinkAddress, simtime_t time)
+unsigned int StatisticCollector::getIndexOfSource(cComponent *source)
+{
+    cModule *host = findContainingNode(check_and_cast<cModule *>(source));
+    auto it = (host != nullptr) ? nodeIndexOfModuleId.find(host->getId()) : nodeIndexOfModuleId.end();
+    if (it == nodeIndexOfModuleId.end())
+        throw cRuntimeError("Signal source %s is not in a node of the nodeStateList!", source->getFullPath().c_str());
+    return it->second;
+}
+
+void StatisticCollector::receiveSignal(cComponent *source, simsignal_t signalID, long l, cObject *details)
+{
+    Enter_Method_Silent();
+
+    NodeState& node = nodeStateList.at(getIndexOfSource(source));
+    if (signalID == helloSentSignal)
+        node.numHelloSent++;
+    else if (signalID == setHLMACSentSignal)
+        node.numHLMACSent++;
+    else if (signalID == neighborAddedSignal){
+        node.numNeighbors++;
+        if (l)
+            node.numAllowedNeighbors++;
+    }
+}
+
+void StatisticCollector::receiveSignal(cComponent *source, simsignal_t signalID, const SimTime& t, cObject *details)
+{
+    Enter_Method_Silent();
+
+    unsigned int nodeID = getIndexOfSource(source);
+    if (signalID == coreStartedSignal)
+        startStatistics(nodeID, t);
+    else if (signalID == hlmacAssignedSignal){
+        //hlmacAddresses mirrors the HLMAC table, so an address saved again after it was removed is only listed once
+        std::vector<HLMACAddress>& addresses = nodeStateList.at(nodeID).hlmacAddresses;
+        const HLMACAddress& address = check_and_cast<HLMACAddressDetails *>(details)->address;
+        if (std::find(addresses.begin(), addresses.end(), address) == addresses.end())
+            addresses.push_back(address);
+        nodeJoined(nodeID, t);
+    }
+    else if (signalID == hlmacRemovedSignal){
+        std::vector<HLMACAddress>& addresses = nodeStateList.at(nodeID).hlmacAddresses;
+        auto it = std::find(addresses.begin(), addresses.end(), check_and_cast<HLMACAddressDetails *>(details)->address);
+        if (it != addresses.end())
+            addresses.erase(it);
+    }
+    else if (signalID == setHLMACReceivedSignal)
+        receiveSetHLMACMessage(t);
+}
+
+void StatisticCollector::startStatistics(unsigned int sinkIndex, simtime_t time)
 {
     Enter_Method("startStatistics()");
 
     simulationEndEvent = new cMessage("simulationEndEvent");
     scheduleAt(simulationTimeInterval, simulationEndEvent);
-    sinkID = getIndexFromMACAddress(sinkAddress);
+    sinkID = sinkIndex;
     convergenceTimeStart = time;
-    nodeJoined(sinkAddress, time);
+    nodeJoined(sinkIndex, time);
 }
 
 unsigned int StatisticCollector::getIndexFromMACAddress(const MACAddress &address)
 {
-    for (unsigned int i = 0; i < nodeStateList.size(); i++){
-        if (nodeStateList.at(i).macAddress == address)
-            return i;
-    }
-    throw cRuntimeError("MAC Address %s is not in the nodeStateList!", address);
+    auto it = nodeIndexOfMAC.find(address.getInt());
+    if (it != nodeIndexOfMAC.end())
+        return it->second;
+    throw cRuntimeError("MAC Address %s is not in the nodeStateList!", address.str().c_str());
 }
 
 void StatisticCollector::nodeJoined(const MACAddress &address, simtime_t time)
 {
     Enter_Method("nodeJoinedDownnward()");
 
-    unsigned int vectorIndex = 0;
-    bool found = false;
-    while(vectorIndex < nodeStateList.size() && (!found)){
-        if (nodeStateList.at(vectorIndex).macAddress == address){
-            found = true;
-            nodeJoined(vectorIndex, time);
-        }
-        vectorIndex++;
-    }
+    auto it = nodeIndexOfMAC.find(address.getInt());
+    if (it != nodeIndexOfMAC.end())
+        nodeJoined(it->second, time);
 }
 
 void StatisticCollector::nodeJoined(int nodeID, simtime_t time)
@@ -137,6 +232,7 @@ void StatisticCollector::nodeJoined(int nodeID, simtime_t time)
     if (!nodeStateList.at(nodeID).isJoined){
         nodeStateList.at(nodeID).isJoined = true;
         nodeStateList.at(nodeID).joiningTime = time;
+        numJoinedNodes++;
 /*      //Convergence time definition: interval time between the first SetHLMAC generation time (or convergenceTimeStart) and the time when the last node is joining to the tree.
         if (convergenceTimeEnd < time){
             convergenceTimeEnd = time;
@@ -154,6 +250,8 @@ void StatisticCollector::nodeJoined(int nodeID, simtime_t time)
 
 void StatisticCollector::receiveSetHLMACMessage(simtime_t time)
 {
+    numSetHLMACEvents++;
+
     //Convergence time definition: interval time between the first SetHLMAC generation time (or convergenceTimeStart) and the time of the last received SetHLMAC in the network.
     if (convergenceTimeEnd < time){
         convergenceTimeEnd = time;
@@ -163,17 +261,15 @@ void StatisticCollector::receiveSetHLMACMessage(simtime_t time)
 void StatisticCollector::collectOtherMetrics()
 {
     for (unsigned int i = 0; i < nodeStateList.size(); i++){
-        //Collects message statistics
-        nodeStateList.at(i).ioToriiOperation->getMessageStatistics(nodeStateList.at(i).numHelloSent, nodeStateList.at(i).numHLMACSent);
+        //Collects message statistics (counted from the signals)
         numHelloSentTotal += nodeStateList.at(i).numHelloSent;
         numHLMACSentTotal += nodeStateList.at(i).numHLMACSent;
 
-        //Collects tables statistics
-        nodeStateList.at(i).ioToriiOperation->getTableStatistics(nodeStateList.at(i).numAllowedNeighbors, nodeStateList.at(i).numNeighbors);
+        //Collects tables statistics (counted from the signals)
         numAllowedNeighborsTotal += nodeStateList.at(i).numAllowedNeighbors;
         numNeighborsTotal += nodeStateList.at(i).numNeighbors;
 
-        nodeStateList.at(i).numHLMACAssigned = nodeStateList.at(i).hlmacAddressTable->getNumberOfAddresses();
+        nodeStateList.at(i).numHLMACAssigned = nodeStateList.at(i).hlmacAddresses.size();
         numHLMACAssignedTotal += nodeStateList.at(i).numHLMACAssigned;
 
         //Other metrics
@@ -209,32 +305,50 @@ void StatisticCollector::handleMessage(cMessage* msg)
 
 bool StatisticCollector::isConverged()
 {
-    for (unsigned int i = 0; i < nodeStateList.size(); i++){
-        if (!nodeStateList.at(i).isJoined)
-            return false;
-    }
-    return true;
+    return numJoinedNodes == nodeStateList.size();
 }
 
 void StatisticCollector::calculateHopCount()
 {
     int numElements = 0;
 
+    //The addresses reported by the signals, in the order of the HLMAC tables (HLMACAddressTable::MAC_compare)
+    for (unsigned int i = 0; i < nodeStateList.size(); i++)
+        std::sort(nodeStateList.at(i).hlmacAddresses.begin(), nodeStateList.at(i).hlmacAddresses.end(),
+                [](const HLMACAddress& u1, const HLMACAddress& u2){ return u1.compareTo(u2) < 0; });
+
+    //Source nodes: all, or a random sample (partial Fisher-Yates shuffle), in increasing order
+    hopCountSources.resize(nodeStateList.size());
+    for (unsigned int i = 0; i < nodeStateList.size(); i++)
+        hopCountSources.at(i) = i;
+    if ((numHopCountSources > 0) && ((unsigned int)numHopCountSources < nodeStateList.size())){
+        for (unsigned int k = 0; k < (unsigned int)numHopCountSources; k++)
+            std::swap(hopCountSources.at(k), hopCountSources.at(k + intuniform(0, nodeStateList.size() - 1 - k)));
+        hopCountSources.resize(numHopCountSources);
+        std::sort(hopCountSources.begin(), hopCountSources.end());
+    }
+
     //hopCount = new int[nodeStateList.size()];
-    hopCount.resize(nodeStateList.size());
-    for (unsigned int i = 0; i < nodeStateList.size(); i++){
+    hopCount.resize(hopCountSources.size());
+    for (unsigned int k = 0; k < hopCount.size(); k++)
         //hopCount[i] = new int[nodeStateList.size()];
-        hopCount.at(i).resize(nodeStateList.size());
+        hopCount.at(k).resize(nodeStateList.size());
+    bool isCalculatedOnTree = calculateHopCountOnTree();
+
+    //same order as the pairwise calculation, so the average (float) and the errors do not change
+    for (unsigned int k = 0; k < hopCount.size(); k++){
+        unsigned int i = hopCountSources.at(k);
         for (unsigned int j = 0; j < nodeStateList.size(); j++){
             if (i == j)
                 //hopCount[i][j] = 0;
-                hopCount.at(i).at(j) = 0;
+                hopCount.at(k).at(j) = 0;
             else{
                 //hopCount[i][j] = findMinHopCount(i, j);
-                hopCount.at(i).at(j) = findMinHopCount(i, j);
-                if (hopCount.at(i).at(j) == -1)
+                if (!isCalculatedOnTree)
+                    hopCount.at(k).at(j) = findMinHopCount(i, j);
+                if (hopCount.at(k).at(j) == -1)
                     throw cRuntimeError("There is not any route between node %d and %d!", i, j);
-                averageNumberofHopCount += hopCount.at(i).at(j);
+                averageNumberofHopCount += hopCount.at(k).at(j);
                 numElements++;
             }
         }
@@ -250,121 +364,268 @@ void StatisticCollector::calculateHopCount()
 */
 }
 
-int StatisticCollector::findMinHopCount(unsigned int src_id, unsigned int dst_id)
+bool StatisticCollector::calculateHopCountOnTree()
 {
-    //EV << "-->StatisticCollector::findMinHopCount()" << endl;
-    int minHopCount = -1;
-    int numberOfAddressesSrc = nodeStateList.at(src_id).hlmacAddressTable->getNumberOfAddresses();
-    int numberOfAddressesDst = nodeStateList.at(dst_id).hlmacAddressTable->getNumberOfAddresses();
-    for (unsigned int i = 0; i < numberOfAddressesDst; i++){
-        HLMACAddress dst = nodeStateList.at(dst_id).hlmacAddressTable->getAddress(i);
-        int newHopCount = nodeStateList.at(src_id).hlmacAddressTable->getMinHopCount(dst);
-        //EV << "newHopCount = " << newHopCount << endl;
-        if (i == 0)
-            minHopCount = newHopCount;
-        else if (newHopCount < minHopCount) {
-                minHopCount = newHopCount;
+    //Trie of the raw IDs of all addresses (trailing zeros included, as getHLMACLength() counts them),
+    //a child is always created after its parent, so the indexes are in topological order
+    std::vector<int> parent(1, -1);
+    std::vector<std::map<unsigned int, int>> children(1);
+    std::vector<std::vector<int>> addressNodes(nodeStateList.size());  //trie node of each address of each node
+    for (unsigned int i = 0; i < nodeStateList.size(); i++){
+        for (auto & address : nodeStateList.at(i).hlmacAddresses){
+            unsigned int length = address.getHLMACLength();
+            if ((length == 0) || (address.getIndexValue(0) == 0))
+                return false;
+            int node = 0;
+            for (unsigned int k = 0; k < length; k++){
+                auto it = children.at(node).find(address.getIndexValue(k));
+                if (it == children.at(node).end()){
+                    it = children.at(node).insert(std::make_pair(address.getIndexValue(k), (int)parent.size())).first;
+                    parent.push_back(node);
+                    children.push_back(std::map<unsigned int, int>());
+                }
+                node = it->second;
+            }
+            addressNodes.at(i).push_back(node);
+        }
+    }
+    if (children.at(0).size() > 1)  //more than one core, some addresses have no common ancestor
+        return false;
+
+    //Row k: distance from the nearest address of node i = hopCountSources[k] to each trie node, upward then downward.
+    //Rows are independent, each worker reads the trie and writes its own rows of hopCount
+    parallelFor(hopCount.size(), [&](unsigned int begin, unsigned int end){
+        std::vector<int> distance(parent.size());
+        for (unsigned int k = begin; k < end; k++){
+            unsigned int i = hopCountSources[k];
+            std::fill(distance.begin(), distance.end(), INT_MAX - 1);
+            for (auto node : addressNodes[i])
+                distance[node] = 0;
+            for (int node = (int)parent.size() - 1; node > 0; node--)
+                distance[parent[node]] = std::min(distance[parent[node]], distance[node] + 1);
+            for (unsigned int node = 1; node < parent.size(); node++)
+                distance[node] = std::min(distance[node], distance[parent[node]] + 1);
+
+            for (unsigned int j = 0; j < addressNodes.size(); j++){
+                int minHopCount = -1;
+                if (!addressNodes[i].empty())
+                    for (auto node : addressNodes[j])
+                        if ((minHopCount == -1) || (distance[node] < minHopCount))
+                            minHopCount = distance[node];
+                hopCount[k][j] = minHopCount;
+            }
+        }
+    });
+    return true;
+}
+
+void StatisticCollector::parallelFor(unsigned int size, const std::function<void(unsigned int, unsigned int)>& body)
+{
+    unsigned int numBlocks = std::min(numThreads, size);
+    if (numBlocks <= 1){
+        body(0, size);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(numBlocks);
+    auto runBlock = [&](unsigned int k){
+        try{
+            body((unsigned long)size * k / numBlocks, (unsigned long)size * (k + 1) / numBlocks);
+        }catch (...){
+            errors[k] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned int k = 1; k < numBlocks; k++){
+        try{
+            workers.push_back(std::thread(runBlock, k));
+        }catch (const std::system_error&){
+            runBlock(k);  //no more threads, the calling thread does it
         }
     }
-    return minHopCount;
+    runBlock(0);
+    for (auto & worker : workers)
+        worker.join();
+    for (auto & error : errors)
+        if (error)
+            std::rethrow_exception(error);
+}
+
+int StatisticCollector::findMinHopCount(unsigned int src_id, unsigned int dst_id)
+{
+    //EV << "-->StatisticCollector::findMinHopCount()" << endl;
+    //the query of the HLMAC table of the source node, on the reported addresses
+    return HLMACAddressTable::getMinHopCount(nodeStateList.at(src_id).hlmacAddresses, nodeStateList.at(dst_id).hlmacAddresses);
 }
 
 void StatisticCollector::saveStatistics()
 {
-    FILE *statisticsCollector;
+    if (writeTextFiles)
+        saveTextStatistics();
+
+    //Main metrics as scalars too, e.g. for the scalability benchmark (see simulations/benchmark)
+    recordScalar("convergenceTime", convergenceTimeEnd.dbl() - convergenceTimeStart.dbl());
+    recordScalar("averageNumberOfEntries", (double) (numAllowedNeighborsTotal + numHLMACAssignedTotal) / nodeStateList.size());
+    recordScalar("averageNumberOfMessages", (double)(numHLMACSentTotal + numHelloSentTotal) / nodeStateList.size());
+    recordScalar("averageHopCount", averageNumberofHopCount);
+
+    if (!resultFile.empty()){
+        cConfigurationEx *config = getEnvir()->getConfigEx();
+        resultSink.setRunKey(config->getActiveConfigName(), config->getActiveRunNumber(), config->getVariable(CFGVAR_SEEDSET));
+        resultSink.addColumn("convergenceTime", convergenceTimeEnd.dbl() - convergenceTimeStart.dbl());
+        resultSink.addColumn("averageNumberOfEntries", (double) (numAllowedNeighborsTotal + numHLMACAssignedTotal) / nodeStateList.size());
+        resultSink.addColumn("averageNumberOfMessages", (double)(numHLMACSentTotal + numHelloSentTotal) / nodeStateList.size());
+        resultSink.addColumn("averageHopCount", averageNumberofHopCount);
+        resultSink.addColumn("allEntriesTotal", numNeighborsTotal + numHLMACAssignedTotal);
+        resultSink.addColumn("hlmacAssignedTotal", numHLMACAssignedTotal);
+        resultSink.addColumn("neighborsTotal", numAllowedNeighborsTotal);
+        resultSink.addColumn("allNeighborsTotal", numNeighborsTotal);
+        resultSink.addColumn("hlmacSentTotal", numHLMACSentTotal);
+        resultSink.addColumn("helloSentTotal", numHelloSentTotal);
+        resultSink.addColumn("numNotJoinedTotal", numNotJoinedTotal);
+        resultSink.addColumn("numWithoutNeighborTotal", numWithoutNeighborTotal);
+        //a sample of the rows is not a hop matrix
+        resultSink.setHopMatrix(&hopCount, (hopCount.size() == nodeStateList.size()) ? hopMatrixFormat : ResultSink::HOP_MATRIX_NONE);
+    }
+
+    //all files are written here, once
+    resultSink.flush(resultFile);
+}
 
+void StatisticCollector::saveTextStatistics()
+{
     //Main metrics
-    statisticsCollector = fopen("02_ConvergenceTime.txt","a");
-    fprintf(statisticsCollector,"%f\n", convergenceTimeEnd.dbl() - convergenceTimeStart.dbl());
-    fclose(statisticsCollector);
+    resultSink.appendText("02_ConvergenceTime.txt", "%f\n", convergenceTimeEnd.dbl() - convergenceTimeStart.dbl());
 
-    statisticsCollector = fopen("03_averageNumberOfEntries.txt","a");
-    fprintf(statisticsCollector,"%f\n", (double) (numAllowedNeighborsTotal + numHLMACAssignedTotal) / nodeStateList.size());
-    fclose(statisticsCollector);
+    resultSink.appendText("03_averageNumberOfEntries.txt", "%f\n", (double) (numAllowedNeighborsTotal + numHLMACAssignedTotal) / nodeStateList.size());
 
-    statisticsCollector = fopen("04_averageNumberOfMessages.txt","a");
-    fprintf(statisticsCollector,"%f\n", (double)(numHLMACSentTotal + numHelloSentTotal) / nodeStateList.size());
-    fclose(statisticsCollector);
+    resultSink.appendText("04_averageNumberOfMessages.txt", "%f\n", (double)(numHLMACSentTotal + numHelloSentTotal) / nodeStateList.size());
 
-    statisticsCollector = fopen("05_HopCount.txt","a");
-    fprintf(statisticsCollector,"%f\n", averageNumberofHopCount);
-    fclose(statisticsCollector);
+    resultSink.appendText("05_HopCount.txt", "%f\n", averageNumberofHopCount);
 
     //Other metrics
-    statisticsCollector = fopen("06_AllEntriesTotal_2.txt","a");
-    fprintf(statisticsCollector,"%d\n", numNeighborsTotal + numHLMACAssignedTotal);
-    fclose(statisticsCollector);
+    resultSink.appendText("06_AllEntriesTotal_2.txt", "%d\n", numNeighborsTotal + numHLMACAssignedTotal);
 
-    statisticsCollector = fopen("07_HLMACAssignedTotal.txt","a");
-    fprintf(statisticsCollector,"%d\n", numHLMACAssignedTotal);
-    fclose(statisticsCollector);
+    resultSink.appendText("07_HLMACAssignedTotal.txt", "%d\n", numHLMACAssignedTotal);
 
-    statisticsCollector = fopen("08_NeighborsTotal.txt","a");
-    fprintf(statisticsCollector,"%d\n", numAllowedNeighborsTotal);
-    fclose(statisticsCollector);
+    resultSink.appendText("08_NeighborsTotal.txt", "%d\n", numAllowedNeighborsTotal);
 
-    statisticsCollector = fopen("09_NeighborsTotal_2.txt","a");
-    fprintf(statisticsCollector,"%d\n", numNeighborsTotal);
-    fclose(statisticsCollector);
+    resultSink.appendText("09_NeighborsTotal_2.txt", "%d\n", numNeighborsTotal);
 
-    statisticsCollector = fopen("10_HLMACSentTotal.txt","a");
-    fprintf(statisticsCollector,"%d\n", numHLMACSentTotal);
-    fclose(statisticsCollector);
+    resultSink.appendText("10_HLMACSentTotal.txt", "%d\n", numHLMACSentTotal);
 
-    statisticsCollector = fopen("11_HelloSentTotal.txt","a");
-    fprintf(statisticsCollector,"%d\n", numHelloSentTotal);
-    fclose(statisticsCollector);
+    resultSink.appendText("11_HelloSentTotal.txt", "%d\n", numHelloSentTotal);
 
-    statisticsCollector = fopen("12_NumNotJoinedTotal.txt","a");
-    fprintf(statisticsCollector,"%d\n", numNotJoinedTotal);
-    fclose(statisticsCollector);
+    resultSink.appendText("12_NumNotJoinedTotal.txt", "%d\n", numNotJoinedTotal);
 
-    statisticsCollector = fopen("13_NumWithoutNeighborTotal.txt","a");
-    fprintf(statisticsCollector,"%d\n", numWithoutNeighborTotal);
-    fclose(statisticsCollector);
+    resultSink.appendText("13_NumWithoutNeighborTotal.txt", "%d\n", numWithoutNeighborTotal);
 
-    statisticsCollector = fopen("14_HLMACAddresses.txt","a");
     for (unsigned int i = 0; i < nodeStateList.size(); i++){
-        fprintf(statisticsCollector,"host[%d]: MAC Address = %s, HLMAC Addresses = \t", i, nodeStateList.at(i).macAddress.str().c_str());
-        for (unsigned int j = 0; j < nodeStateList.at(i).hlmacAddressTable->getNumberOfAddresses(); j++){
-            fprintf(statisticsCollector,"%s\t", nodeStateList.at(i).hlmacAddressTable->getAddress(j).str().c_str());
+        resultSink.appendText("14_HLMACAddresses.txt", "host[%d]: MAC Address = %s, HLMAC Addresses = \t", i, nodeStateList.at(i).macAddress.str().c_str());
+        //hlmacAddresses is the snapshot of calculateHopCount(), in the order of getAddress(j)
+        for (auto & address : nodeStateList.at(i).hlmacAddresses){
+            resultSink.appendText("14_HLMACAddresses.txt", "%s\t", address.str().c_str());
         }
-        fprintf(statisticsCollector,"\n");
+        resultSink.appendText("14_HLMACAddresses.txt", "\n");
     }
-    fprintf(statisticsCollector,"\n ---------------------------------------------------- \n");
-    fclose(statisticsCollector);
+    resultSink.appendText("14_HLMACAddresses.txt", "\n ---------------------------------------------------- \n");
 
-    statisticsCollector = fopen("15_hopCountInfo.txt","a");
     for (unsigned int i = 0; i < hopCount.size(); i++){
-        for (unsigned int j = 0; j < hopCount.size(); j++){
-            //fprintf(statisticsCollector,"%3d\t", hopCount[i][j]);
-            fprintf(statisticsCollector,"%3d\t", hopCount.at(i).at(j));
+        for (unsigned int j = 0; j < hopCount.at(i).size(); j++){
+            //resultSink.appendText("15_hopCountInfo.txt", "%3d\t", hopCount[i][j]);
+            resultSink.appendText("15_hopCountInfo.txt", "%3d\t", hopCount.at(i).at(j));
             if((i != j) && (hopCount.at(i).at(j) != -1)){
             }
         }
-        fprintf(statisticsCollector,"\n");
+        resultSink.appendText("15_hopCountInfo.txt", "\n");
+    }
+    resultSink.appendText("15_hopCountInfo.txt", "\n ---------------------------------------------------- \n");
+
+    resultSink.appendText("01_IoToriiGlobalStats.txt", " _____________________________________________________________________________________\n");
+    resultSink.appendText("01_IoToriiGlobalStats.txt", "|Results of new run                                                |\n");
+    resultSink.appendText("01_IoToriiGlobalStats.txt", "|------------------------------------------------------------------|------------------\n");
+    resultSink.appendText("01_IoToriiGlobalStats.txt", "| Convergence Time (Total joining time)                            | %f\n", convergenceTimeEnd.dbl() - convergenceTimeStart.dbl());
+    resultSink.appendText("01_IoToriiGlobalStats.txt", "| Number of total table entries (HLMAC table + Neighbor table)     | %d\n", numAllowedNeighborsTotal + numHLMACAssignedTotal);
+    resultSink.appendText("01_IoToriiGlobalStats.txt", "| Number of All total table entries (HLMAC table + Neighbor table) | %d\n", numNeighborsTotal + numHLMACAssignedTotal);
+    resultSink.appendText("01_IoToriiGlobalStats.txt", "| Number of total assigned HLMAC (or number of HLMAC table entries)| %d\n", numHLMACAssignedTotal);
+    resultSink.appendText("01_IoToriiGlobalStats.txt", "| Number of tot limited neighbors(number of neighbor table entries)| %d\n", numAllowedNeighborsTotal);
+    resultSink.appendText("01_IoToriiGlobalStats.txt", "| Number of ALL total neighbors (All neighbor table entries)       | %d\n", numNeighborsTotal);
+    resultSink.appendText("01_IoToriiGlobalStats.txt", "| Number of total messages (Hello + HLMAC)                         | %d\n", numHLMACSentTotal + numHelloSentTotal);
+    resultSink.appendText("01_IoToriiGlobalStats.txt", "| Number of total sent HLMAC                                       | %d\n", numHLMACSentTotal);
+    resultSink.appendText("01_IoToriiGlobalStats.txt", "| Number of total sent Hello                                       | %d\n", numHelloSentTotal);
+    resultSink.appendText("01_IoToriiGlobalStats.txt", "| Number of average Hop Count                                      | %f\n", averageNumberofHopCount);
+    resultSink.appendText("01_IoToriiGlobalStats.txt", "| Number of total disjoint to Tree                                 | %d\n", numNotJoinedTotal);
+    resultSink.appendText("01_IoToriiGlobalStats.txt", "| Number of total without any neighbor                             | %d\n", numWithoutNeighborTotal);
+    resultSink.appendText("01_IoToriiGlobalStats.txt", "|__________________________________________________________________|__________________\n");
+}
+
+void StatisticCollector::checkAddressesAreUnique()
+{
+    //(address, node) pairs of all nodes, sorted by address, so an address of two nodes is in adjacent pairs
+    std::vector<std::pair<HLMACAddress, unsigned int>> addresses;
+    for (unsigned int i = 0; i < nodeStateList.size(); i++)
+        for (auto & address : nodeStateList.at(i).hlmacAddresses)
+            addresses.push_back(std::make_pair(address, i));
+    std::sort(addresses.begin(), addresses.end(),
+            [](const std::pair<HLMACAddress, unsigned int>& u1, const std::pair<HLMACAddress, unsigned int>& u2){ return u1.first.compareTo(u2.first) < 0; });
+    for (unsigned int k = 1; k < addresses.size(); k++)
+        if (addresses[k - 1].first.compareTo(addresses[k].first) == 0)
+            throw cRuntimeError("HLMAC address %s is assigned to both %s and %s", addresses[k].first.str().c_str(),
+                    nodeStateList.at(addresses[k - 1].second).fullName.c_str(), nodeStateList.at(addresses[k].second).fullName.c_str());
+}
+
+void StatisticCollector::finish()
+{
+    if (checkUniqueAddresses)
+        checkAddressesAreUnique();
+
+    //Benchmark of HLMACAddress storage (built with -DHLMAC_BENCHMARK), see simulations/benchmark
+    recordScalar("numSetHLMACEvents", numSetHLMACEvents);
+#ifdef HLMAC_BENCHMARK
+    unsigned long hlmacCopies = HLMACAddress::numCopies - hlmacCopiesAtStart;
+    unsigned long hlmacHeapAllocations = HLMACAddress::numHeapAllocations - hlmacHeapAllocationsAtStart;
+    recordScalar("hlmacCopies", hlmacCopies);
+    recordScalar("hlmacHeapAllocations", hlmacHeapAllocations);
+    if (numSetHLMACEvents > 0){
+        //with the former std::vector storage, every copy of an address was a heap allocation (and not only those)
+        recordScalar("hlmacCopiesPerSetHLMAC", (double) hlmacCopies / numSetHLMACEvents);
+        recordScalar("hlmacHeapAllocationsPerSetHLMAC", (double) hlmacHeapAllocations / numSetHLMACEvents);
+    }
+
+    //Benchmark of the shared targetOptions of SetHLMAC frames: before, every frame copy (one per receiver) copied the array
+    recordScalar("setHLMACFrameCopies", SetHLMACFrame::numCopies - setHLMACFrameCopiesAtStart);
+    recordScalar("targetOptionArrays", SetHLMACFrame::numTargetOptionArrays - targetOptionArraysAtStart);
+#endif
+
+    //End-to-end bootstrap time: from the beginning of the simulation (Hello phase and core start included) to the last received SetHLMAC
+    recordScalar("coreStartTime", convergenceTimeStart);
+    if (numSetHLMACEvents > 0)
+        recordScalar("bootstrapTime", convergenceTimeEnd);
+
+    //Simulation speed, e.g. to compare builds with and without IoTorii logging (see IoToriiLog.h)
+    double wallClockTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallClockAtStart).count();
+    eventnumber_t numEvents = getSimulation()->getEventNumber() - eventNumberAtStart;
+    recordScalar("numEvents", numEvents);
+    recordScalar("wallClockTime", wallClockTime);
+    if (wallClockTime > 0)
+        recordScalar("eventsPerSecond", numEvents / wallClockTime);
+
+    //Size of the run, and peak memory of the process (the whole network, all runs of the process so far)
+    recordScalar("numNodes", nodeStateList.size());
+    recordScalar("numJoinedNodes", numJoinedNodes);
+    double peakRSS = IoToriiNetwork::getPeakRSS();
+    if (peakRSS >= 0){
+        recordScalar("peakRSS", peakRSS, "B");
+        //saved when the network module was created, if the network is an IoToriiNetwork (e.g. ScalabilityNet)
+        IoToriiNetwork *network = dynamic_cast<IoToriiNetwork *>(getSimulation()->getSystemModule());
+        double peakRSSBeforeSetup = network ? network->getPeakRSSBeforeSetup() : -1;
+        if (peakRSSBeforeSetup >= 0){
+            //the peak is a high-water mark of the process, so the difference is the network only for its first run
+            recordScalar("peakRSSBeforeSetup", peakRSSBeforeSetup, "B");
+            if (!nodeStateList.empty())
+                recordScalar("peakRSSPerNode", (peakRSS - peakRSSBeforeSetup) / nodeStateList.size(), "B");
+        }
     }
-    fprintf(statisticsCollector,"\n ---------------------------------------------------- \n");
-    fclose(statisticsCollector);
-
-    statisticsCollector = fopen("01_IoToriiGlobalStats.txt","a");
-    fprintf(statisticsCollector," _____________________________________________________________________________________\n");
-    fprintf(statisticsCollector,"|Results of new run                                                |\n");
-    fprintf(statisticsCollector,"|------------------------------------------------------------------|------------------\n");
-    fprintf(statisticsCollector,"| Convergence Time (Total joining time)                            | %f\n", convergenceTimeEnd.dbl() - convergenceTimeStart.dbl());
-    fprintf(statisticsCollector,"| Number of total table entries (HLMAC table + Neighbor table)     | %d\n", numAllowedNeighborsTotal + numHLMACAssignedTotal);
-    fprintf(statisticsCollector,"| Number of All total table entries (HLMAC table + Neighbor table) | %d\n", numNeighborsTotal + numHLMACAssignedTotal);
-    fprintf(statisticsCollector,"| Number of total assigned HLMAC (or number of HLMAC table entries)| %d\n", numHLMACAssignedTotal);
-    fprintf(statisticsCollector,"| Number of tot limited neighbors(number of neighbor table entries)| %d\n", numAllowedNeighborsTotal);
-    fprintf(statisticsCollector,"| Number of ALL total neighbors (All neighbor table entries)       | %d\n", numNeighborsTotal);
-    fprintf(statisticsCollector,"| Number of total messages (Hello + HLMAC)                         | %d\n", numHLMACSentTotal + numHelloSentTotal);
-    fprintf(statisticsCollector,"| Number of total sent HLMAC                                       | %d\n", numHLMACSentTotal);
-    fprintf(statisticsCollector,"| Number of total sent Hello                                       | %d\n", numHelloSentTotal);
-    fprintf(statisticsCollector,"| Number of average Hop Count                                      | %f\n", averageNumberofHopCount);
-    fprintf(statisticsCollector,"| Number of total disjoint to Tree                                 | %d\n", numNotJoinedTotal);
-    fprintf(statisticsCollector,"| Number of total without any neighbor                             | %d\n", numWithoutNeighborTotal);
-    fprintf(statisticsCollector,"|__________________________________________________________________|__________________\n");
-    fclose(statisticsCollector);
 }
 
 StatisticCollector::~StatisticCollector()
@@ -24,26 +24,39 @@
 #define IOTORII_SRC_STATISTIC_STATISTICCOLLECTOR_H
 
 #include "inet/common/INETDefs.h"
+#include <functional>
+#include <chrono>
+#include <unordered_map>
+#include "inet/linklayer/common/MACAddress.h"
 #include "src/linklayer/common/HLMACAddress.h"
-#include "src/linklayer/IoTorii/IoToriiOperation.h"
-#include "src/linklayer/IoTorii/IHLMACAddressTable.h"
+#include "src/linklayer/IoTorii/IoToriiSignals.h"
+#include "src/statisticcollector/ResultSink.h"
 
 
 namespace iotorii {
 using namespace inet;
 
-class StatisticCollector : public cSimpleModule
+/**
+ * Collects the metrics of a run from the signals of the IoToriiOperation modules (see IoToriiSignals.h),
+ * which it subscribes to at the network module, so it does not call any node and no node calls it.
+ */
+class StatisticCollector : public cSimpleModule, public cListener
 {
 
     simtime_t simulationTimeInterval;
     cMessage *simulationEndEvent;
+    unsigned int numThreads;  //worker threads of the end-of-run calculations
+
+    ResultSink resultSink;
+    bool writeTextFiles;  //the former 01_ to 15_ text files
+    std::string resultFile;  //binary file of the runs, empty if it is not written
+    ResultSink::HopMatrixFormat hopMatrixFormat;  //of the hop matrix in resultFile
 
     struct NodeState{
         std::string fullName;
         int moduleIndex;
         cModule *host;
-        IoToriiOperation *ioToriiOperation;
-        IHLMACAddressTable *hlmacAddressTable;
+        std::vector<HLMACAddress> hlmacAddresses;  //addresses in the HLMAC table (hlmacAssigned, minus hlmacRemoved), sorted as in the HLMAC table by calculateHopCount()
         MACAddress macAddress;
         //HLMACAddress hlmacAddress;
 
@@ -74,8 +87,6 @@ class StatisticCollector : public cSimpleModule
         NodeState()
             : host(nullptr)
             , moduleIndex(-1)
-            , ioToriiOperation(nullptr)
-            , hlmacAddressTable(nullptr)
             , macAddress(MACAddress::UNSPECIFIED_ADDRESS)
             //, hlmacAddress(HLMACAddress::UNSPECIFIED_ADDRESS)
             , hlmacLenIsLow(false)
@@ -105,13 +116,16 @@ class StatisticCollector : public cSimpleModule
 
     typedef std::vector<struct NodeState> NodeStateList;
     NodeStateList nodeStateList;
+    std::unordered_map<uint64, unsigned int> nodeIndexOfMAC;  //MACAddress::getInt() -> index in nodeStateList, filled by extractTopology()
+    std::unordered_map<int, unsigned int> nodeIndexOfModuleId;  //host module ID -> index in nodeStateList, filled by extractTopology()
+    unsigned int numJoinedNodes;  //number of nodes with isJoined, so isConverged() does not scan nodeStateList
 
     //int version;
     unsigned int sinkID;
     //IPv6Address sinkLLAddress;
 
     //Global statistics
-    simtime_t convergenceTimeStart;  //this is set by core start time
+    simtime_t convergenceTimeStart;  //this is set by core start time (fixed or adaptive, see IoToriiOperation coreQuietPeriod)
     simtime_t convergenceTimeEnd;   //interval time between the first SetHLMAC generation time (or convergenceTimeStart) and the time of the last received (AND ASSIGNED) SetHLMAC in the network.
     int numHLMACAssignedTotal;
     int numNeighborsTotal;  //saves all available neighbors
@@ -122,13 +136,33 @@ class StatisticCollector : public cSimpleModule
     int numWithoutNeighborTotal;
 
     //int **hopCount;
-    std::vector<std::vector <int>> hopCount;
+    std::vector<std::vector <int>> hopCount;  //row k: hop counts from node hopCountSources[k] to all nodes
+    int numHopCountSources;  //hopCountSources parameter, 0: all nodes
+    std::vector<unsigned int> hopCountSources;  //sorted node indexes, all nodes if the matrix is complete
     float averageNumberofHopCount;
+    bool checkUniqueAddresses;  //finish() checks that no HLMAC address is assigned to two nodes
+
+    //HLMACAddress storage statistics, HLMACAddress counters are process-wide, so they are saved at the beginning of each run
+    long numSetHLMACEvents;
+#ifdef HLMAC_BENCHMARK
+    unsigned long hlmacCopiesAtStart;
+    unsigned long hlmacHeapAllocationsAtStart;
+    unsigned long setHLMACFrameCopiesAtStart;
+    unsigned long targetOptionArraysAtStart;
+#endif
+
+    //Simulation speed, measured from the end of the initialization to finish()
+    std::chrono::steady_clock::time_point wallClockAtStart;
+    eventnumber_t eventNumberAtStart;
 
 public:
     StatisticCollector()
         : simulationEndEvent(nullptr)
         , simulationTimeInterval(SIMTIME_ZERO)
+        , numThreads(1)
+        , writeTextFiles(true)
+        , hopMatrixFormat(ResultSink::HOP_MATRIX_NONE)
+        , numJoinedNodes(0)
         , sinkID(-1)
         , convergenceTimeStart(SIMTIME_ZERO)
         , convergenceTimeEnd(SIMTIME_ZERO)
@@ -140,6 +174,16 @@ public:
         , numNotJoinedTotal(0)   //The number of nodes which are not joined to tree
         , numWithoutNeighborTotal(0)
         , averageNumberofHopCount(0)
+        , checkUniqueAddresses(false)
+        , numHopCountSources(0)
+        , numSetHLMACEvents(0)
+#ifdef HLMAC_BENCHMARK
+        , hlmacCopiesAtStart(0)
+        , hlmacHeapAllocationsAtStart(0)
+        , setHLMACFrameCopiesAtStart(0)
+        , targetOptionArraysAtStart(0)
+#endif
+        , eventNumberAtStart(0)
             {};
 
     ~StatisticCollector();
@@ -153,18 +197,50 @@ protected:
 
     virtual void saveStatistics();
 
+    virtual void saveTextStatistics();
+
     virtual void handleMessage(cMessage* msg);
 
+    virtual void finish();
+
     virtual bool isConverged();
 
     virtual void collectOtherMetrics();
 
     virtual void calculateHopCount();
 
+    /**
+     * Throws if two nodes have the same HLMAC address, e.g. a node that took the address of a target with its short ID
+     */
+    virtual void checkAddressesAreUnique();
+
+    /**
+     * Fills hopCount from one trie of the addresses of all nodes: hop count of two addresses is their
+     * distance in this trie, so each row is a multi-source tree distance (two passes over the trie) instead
+     * of a numHopsBetweenAddresses() call per pair of addresses. Returns false, and fills nothing, if
+     * the addresses are not all under one nonzero core ID, where numHopsBetweenAddresses() must report the error.
+     */
+    virtual bool calculateHopCountOnTree();
+
+    /**
+     * Calls body(begin, end) for numThreads contiguous blocks of [0, size) on worker threads and waits for all of them.
+     * body must only read shared state and write its own block; the exception of the first failed block is rethrown.
+     */
+    virtual void parallelFor(unsigned int size, const std::function<void(unsigned int, unsigned int)>& body);
+
     virtual int findMinHopCount(unsigned int src_id, unsigned int dst_id);
 
+    /**
+     * Returns the index in nodeStateList of the host of an IoToriiOperation module that emitted a signal
+     */
+    virtual unsigned int getIndexOfSource(cComponent *source);
+
+    virtual void startStatistics(unsigned int sinkIndex, simtime_t time);
+
 public:
-    virtual void startStatistics(const MACAddress &sinkAddress, simtime_t time);
+    virtual void receiveSignal(cComponent *source, simsignal_t signalID, long l, cObject *details) override;
+
+    virtual void receiveSignal(cComponent *source, simsignal_t signalID, const SimTime& t, cObject *details) override;
 
     virtual unsigned int getIndexFromMACAddress(const MACAddress &address);
 
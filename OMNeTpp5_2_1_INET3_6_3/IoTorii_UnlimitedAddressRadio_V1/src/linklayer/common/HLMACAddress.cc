@@ -27,49 +27,84 @@
 namespace iotorii {
 
 unsigned int unspecifiedArray[8] = {0,0,0,0,0,0,0,0};
-const HLMACAddress HLMACAddress::UNSPECIFIED_ADDRESS(unspecifiedArray);
+const HLMACAddress HLMACAddress::UNSPECIFIED_ADDRESS(unspecifiedArray, 8);
 unsigned int broadcastArray[8] = {255,255,255,255,255,255,255,255};
-const HLMACAddress HLMACAddress::BROADCAST_ADDRESS(broadcastArray);
+const HLMACAddress HLMACAddress::BROADCAST_ADDRESS(broadcastArray, 8);
 
 
+HLMACAddress::HLMACAddress(const unsigned int array[], unsigned int arrayLength) :
+    length(0),
+    capacity(HLMAC_INLINE_LENGTH),
+    ids(inlineIds)
+{
+    reserve(arrayLength);
+    for (unsigned int i = 0; i < arrayLength; i++)
+        ids[i] = array[i];
+    length = arrayLength;
+}
+
+/*
+ * Grows the storage to at least newCapacity IDs. Addresses up to HLMAC_INLINE_LENGTH IDs
+ * never get here, so only very deep trees pay for a heap block.
+ */
+void HLMACAddress::reserve(unsigned int newCapacity)
+{
+    if (newCapacity <= capacity)
+        return;
+    unsigned int *newIds = new unsigned int[newCapacity];
+    for (unsigned int i = 0; i < length; i++)
+        newIds[i] = ids[i];
+    if (ids != inlineIds)
+        delete[] ids;
+    ids = newIds;
+    capacity = newCapacity;
+}
+
+void HLMACAddress::copyFrom(const HLMACAddress& other)
+{
+    if ((other.length <= HLMAC_INLINE_LENGTH) && (ids != inlineIds))
+        releaseStorage();  //don't keep a heap block for a short address
+    reserve(other.length);
+    for (unsigned int i = 0; i < other.length; i++)
+        ids[i] = other.ids[i];
+    length = other.length;
+}
+
 std::string HLMACAddress::str() const
 {
-    char *buf = new char[address.size() * (4 +1) + 1];  //first 1 for dot, second 1 for "\0"
-    char *s = buf;
-    int i;
-    for (i = 0; i < address.size(); i++, s += 5)
-        sprintf(s, "%4.4u.", getIndexValue(i));
-    *(s) = '\0';
-    return std::string(buf);
+    std::string buf;
+    buf.reserve(length * (4 + 1));  //1 for dot
+    char s[16];
+    for (unsigned int i = 0; i < length; i++) {
+        sprintf(s, "%4.4u.", ids[i]);
+        buf += s;
+    }
+    return buf;
 }
 
 int HLMACAddress::compareTo(const HLMACAddress& other) const
 {
-    int minSize = (address.size() < other.address.size()) ? address.size() : other.address.size();
+    unsigned int minSize = (length < other.length) ? length : other.length;
 
-    for (int i=0; i<minSize; i++){
-        if (address.at(i) > other.address.at(i))
+    for (unsigned int i=0; i<minSize; i++){
+        if (ids[i] > other.ids[i])
             return +1;
-        else if (address.at(i) < other.address.at(i))
+        else if (ids[i] < other.ids[i])
             return -1;
     }
-    if (address.size() == other.address.size())
-        return 0;
-    else if (address.size() > other.address.size()){
-        for (int i=minSize; i< address.size(); i++){
-            if (address.at(i) > 0)
+    if (length > other.length){
+        for (unsigned int i=minSize; i< length; i++){
+            if (ids[i] > 0)
                 return +1;
         }
-        return 0;
     }
-    else if (address.size() < other.address.size()){
-        for (int i=minSize; i< other.address.size(); i++){
-            if (other.address.at(i) > 0)
+    else if (length < other.length){
+        for (unsigned int i=minSize; i< other.length; i++){
+            if (other.ids[i] > 0)
                 return -1;
         }
-        return 0;
     }
-
+    return 0;
 }
 
 /*
@@ -0,0 +1,148 @@
+#!/bin/bash
+# Runs the (config, repetition) pairs of an ini file of an IoTorii project on several local cores.
+#
+# Usage: runsweep.sh [-j JOBS] [-o OUTDIR] [-c "CONFIG..."] [-m] INIFILE
+#   -j JOBS     number of simultaneous runs (default: number of cores)
+#   -o OUTDIR   output folder (default: sweep-<ini name> next to the ini file)
+#   -c CONFIGS  configs to run, separated by spaces (default: all [Config ...] sections of the ini file)
+#   -m          only merge the results of the finished runs
+#
+# Each run is executed in its own folder, OUTDIR/<config>/<run number>, so the result files that the
+# StatisticCollector appends (e.g. 02_ConvergenceTime.txt, IoToriiResults.dat) and the .sca/.vec files of
+# concurrent runs do not mix. A finished run has a DONE file; running the script again (e.g. after an
+# interruption) skips the finished runs and restarts the others from scratch.
+# At the end, OUTDIR/merged/<config> gets each text file of the runs concatenated in run number order,
+# i.e. the same files as a sequential run of the config, and OUTDIR/merged gets the binary records of all
+# runs (IoToriiResults.dat) and the .sca/.vec files.
+#
+# The simulation executable is <project>/IoTorii and the NED path is <project>:<project>/../inet/src,
+# where <project> is the folder two levels above the ini file (e.g. <project>/simulations/article);
+# set IOTORII_BIN and IOTORII_NEDPATH to change them.
+
+JOBS=$(nproc 2> /dev/null || echo 1)
+OUTDIR=
+CONFIGS=
+MERGEONLY=0
+
+while getopts "j:o:c:m" OPTION; do
+	case $OPTION in
+	j) JOBS=$OPTARG ;;
+	o) OUTDIR=$OPTARG ;;
+	c) CONFIGS=$OPTARG ;;
+	m) MERGEONLY=1 ;;
+	*) sed -n '2,8p' "$0"; exit 1 ;;
+	esac
+done
+shift $((OPTIND - 1))
+
+if [ $# -ne 1 ] || [ ! -f "$1" ]; then
+	sed -n '2,8p' "$0"
+	exit 1
+fi
+
+INI=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+INIDIR=$(dirname "$INI")
+PROJECT=$(cd "$INIDIR/../.." && pwd)
+BIN=${IOTORII_BIN:-$PROJECT/IoTorii}
+NEDPATH=${IOTORII_NEDPATH:-$PROJECT:$PROJECT/../inet/src}
+OUTDIR=${OUTDIR:-$INIDIR/sweep-$(basename "$INI" .ini)}
+if [ -z "$CONFIGS" ]; then
+	CONFIGS=$(sed -n 's/^\[Config[ \t]\+\([^] \t]*\)[ \t]*\].*/\1/p' "$INI")
+fi
+
+mkdir -p "$OUTDIR" || exit 1
+OUTDIR=$(cd "$OUTDIR" && pwd)
+
+# Number of runs of a config, saved so that the merge does not need the executable
+numruns() {
+	if [ ! -f "$OUTDIR/$1/NUMRUNS" ]; then
+		mkdir -p "$OUTDIR/$1"
+		"$BIN" -u Cmdenv -f "$INI" -n "$NEDPATH" -c "$1" -q numruns 2> /dev/null | sed -n 's/^Number of runs: *\([0-9]\+\).*/\1/p' > "$OUTDIR/$1/NUMRUNS.tmp"
+		if [ ! -s "$OUTDIR/$1/NUMRUNS.tmp" ]; then
+			echo "Cannot get the number of runs of config $1 with $BIN" >&2
+			rm -f "$OUTDIR/$1/NUMRUNS.tmp"
+			return 1
+		fi
+		mv "$OUTDIR/$1/NUMRUNS.tmp" "$OUTDIR/$1/NUMRUNS"
+	fi
+	cat "$OUTDIR/$1/NUMRUNS"
+}
+
+# Runs one (config, run number) pair in its own folder, called by xargs
+runone() {
+	RUNDIR=$OUTDIR/$1/$2
+	rm -rf "$RUNDIR"
+	mkdir -p "$RUNDIR"
+	cd "$RUNDIR" || return 1
+	START=$(date +%s.%N)
+	"$BIN" -u Cmdenv -f "$INI" -n "$NEDPATH" -c "$1" -r "$2" --result-dir=. --cmdenv-express-mode=true > run.log 2>&1
+	RV=$?
+	END=$(date +%s.%N)
+	echo "$START $END" > WALLCLOCK
+	if [ $RV -eq 0 ]; then
+		touch DONE
+		echo "$1 run $2 OK"
+	else
+		echo "$1 run $2 FAIL, see $RUNDIR/run.log"
+	fi
+	return 0
+}
+
+SWEEPSTART=$(date +%s)
+
+if [ $MERGEONLY -eq 0 ]; then
+	if [ ! -x "$BIN" ]; then
+		echo "$BIN is not executable, set IOTORII_BIN" >&2
+		exit 1
+	fi
+	export -f runone
+	export OUTDIR INI BIN NEDPATH
+
+	# all pending pairs, in config and run number order
+	for CONFIG in $CONFIGS; do
+		NUMRUNS=$(numruns "$CONFIG") || exit 1
+		for (( RUN=0; RUN<NUMRUNS; RUN++ )); do
+			[ -f "$OUTDIR/$CONFIG/$RUN/DONE" ] || echo "$CONFIG $RUN"
+		done
+	done > "$OUTDIR/PENDING"
+
+	echo "$(wc -l < "$OUTDIR/PENDING") runs to do with $JOBS jobs, results in $OUTDIR"
+	xargs -P "$JOBS" -L 1 bash -c 'runone "$0" "$1"' < "$OUTDIR/PENDING"
+	rm -f "$OUTDIR/PENDING"
+fi
+
+# merge, in config and run number order
+MERGED=$OUTDIR/merged
+rm -rf "$MERGED"
+mkdir -p "$MERGED"
+declare -i TOTAL=0
+declare -i DONECOUNT=0
+for CONFIG in $CONFIGS; do
+	NUMRUNS=$(numruns "$CONFIG") || exit 1
+	mkdir -p "$MERGED/$CONFIG"
+	for (( RUN=0; RUN<NUMRUNS; RUN++ )); do
+		TOTAL+=1
+		RUNDIR=$OUTDIR/$CONFIG/$RUN
+		[ -f "$RUNDIR/DONE" ] || continue
+		DONECOUNT+=1
+		for FILE in "$RUNDIR"/*.txt; do
+			[ -f "$FILE" ] && cat "$FILE" >> "$MERGED/$CONFIG/$(basename "$FILE")"
+		done
+		for FILE in "$RUNDIR"/*.dat; do
+			[ -f "$FILE" ] && cat "$FILE" >> "$MERGED/$(basename "$FILE")"  # records are self-contained, see ResultSink.h
+		done
+		for FILE in "$RUNDIR"/*.sca "$RUNDIR"/*.vec "$RUNDIR"/*.vci; do
+			[ -f "$FILE" ] && cp "$FILE" "$MERGED/"
+		done
+	done
+done
+
+# wall-clock time of the sweep, and the sum over the runs (= time of a sequential sweep)
+RUNSECONDS=$(cat "$OUTDIR"/*/*/WALLCLOCK 2> /dev/null | awk '{ sum += $2 - $1 } END { printf "%.0f", sum }')
+printf "%d/%d runs done, this invocation took %ds, the runs took %ss in total\n" "$DONECOUNT" "$TOTAL" "$(( $(date +%s) - SWEEPSTART ))" "$RUNSECONDS" | tee "$MERGED/SUMMARY"
+
+if [ $DONECOUNT -ne $TOTAL ]; then
+	echo "The sweep is incomplete, run the same command again to finish it"
+	exit 2
+fi
+exit 0